@@ -1,11 +1,185 @@
 #pragma once
 #include<vector>
 #include "flight.h"
+#include "column_scan.h"
+#include "thread_pool.h"
 #include<algorithm>
 #include<string>
 #include<ctime>
+#include<iterator>
+#include<functional>
+#include<numeric>
+#include<cstdint>
+#include<limits>
+#include<stdexcept>
 using namespace std;
 
+// Обобщенные шаблоны поиска по отсортированному диапазону с произвольным доступом
+// [first, last) и проекцией proj (ключ элемента: поле записи, значение столбца).
+// Позиции и длины - difference_type итератора (64 бита), поэтому размер диапазона
+// не ограничен 2^31. Версии для vector<flight> ниже построены на них
+
+// Проекция по умолчанию: сам элемент
+struct identity_projection {
+	template<typename T>
+	const T& operator()(const T& value) const { return value; }
+};
+
+// Первая позиция, где proj(элемент) >= value
+template<typename RandomIt, typename T, typename Projection = identity_projection>
+RandomIt lower_bound_by(RandomIt first, RandomIt last, const T& value, Projection proj = {}) {
+	auto len = last - first;
+	while (len > 0) {
+		auto half = len / 2;
+		RandomIt mid = first + half;
+		if (proj(*mid) < value) {
+			first = mid + 1;
+			len -= half + 1;
+		}
+		else {
+			len = half;
+		}
+	}
+	return first;
+}
+
+// Первая позиция, где proj(элемент) > value
+template<typename RandomIt, typename T, typename Projection = identity_projection>
+RandomIt upper_bound_by(RandomIt first, RandomIt last, const T& value, Projection proj = {}) {
+	auto len = last - first;
+	while (len > 0) {
+		auto half = len / 2;
+		RandomIt mid = first + half;
+		if (value < proj(*mid)) {
+			len = half;
+		}
+		else {
+			first = mid + 1;
+			len -= half + 1;
+		}
+	}
+	return first;
+}
+
+template<typename RandomIt, typename T, typename Projection = identity_projection>
+pair<RandomIt, RandomIt> equal_range_by(RandomIt first, RandomIt last, const T& value, Projection proj = {}) {
+	RandomIt lower = lower_bound_by(first, last, value, proj);
+	return { lower, upper_bound_by(lower, last, value, proj) };
+}
+
+// Галоп от from: шаг удваивается, пока ключ меньше value, затем бинарный поиск
+// в последнем шаге. O(log d), где d - расстояние от from до ответа
+template<typename RandomIt, typename T, typename Projection = identity_projection>
+RandomIt gallop_lower_bound_by(RandomIt from, RandomIt last, const T& value, Projection proj = {}) {
+	auto n = last - from;
+	decltype(n) step = 1;
+	decltype(n) bot = 0;
+	while (step <= n && proj(from[step - 1]) < value) {
+		bot = step;
+		step *= 2;
+	}
+	return lower_bound_by(from + bot, from + min(n, step - 1), value, proj);
+}
+
+// То же для первой позиции с ключом > value: O(log k), где k - число равных value записей от from
+template<typename RandomIt, typename T, typename Projection = identity_projection>
+RandomIt gallop_upper_bound_by(RandomIt from, RandomIt last, const T& value, Projection proj = {}) {
+	auto n = last - from;
+	decltype(n) step = 1;
+	decltype(n) bot = 0;
+	while (step <= n && !(value < proj(from[step - 1]))) {
+		bot = step;
+		step *= 2;
+	}
+	return upper_bound_by(from + bot, from + min(n, step - 1), value, proj);
+}
+
+// Fibonacci поиск одного совпадения, границы диапазона уточняются бинарным поиском.
+// Промах - пустой диапазон {last, last}
+template<typename RandomIt, typename T, typename Projection = identity_projection>
+pair<RandomIt, RandomIt> fibonacci_equal_range_by(RandomIt first, RandomIt last, const T& value, Projection proj = {}) {
+	auto n = last - first;
+	decltype(n) a = 0, b = 0, c = 1;
+	while (c < n) {
+		a = b;
+		b = c;
+		c = a + b;
+	}
+
+	// Все позиции < offset меньше искомого
+	decltype(n) offset = 0;
+
+	while (c > 1) {
+		auto i = min(offset + a - 1, n - 1);
+		auto i_value = proj(first[i]);
+		if (i_value < value) {
+			c = b;
+			b = a;
+			a = c - b;
+			offset = i + 1;
+		}
+		else if (value < i_value) {
+			c = a;
+			b = b - a;
+			a = c - b;
+		}
+		else {
+			return { lower_bound_by(first + offset, first + i, value, proj),
+				upper_bound_by(first + i + 1, last, value, proj) };
+		}
+	}
+	// Остается один непроверенный кандидат
+	if (offset < n && !(proj(first[offset]) < value) && !(value < proj(first[offset]))) {
+		return { first + offset, upper_bound_by(first + offset + 1, last, value, proj) };
+	}
+	return { last, last };
+}
+
+// Интерполяционный поиск нижней границы для числовых ключей: позиция пробы
+// оценивается линейно между последними пробами слева (< искомого) и справа (>= искомого).
+// На равномерно распределенных ключах - O(log log n) проб. Если проба не сократила
+// окно вдвое (неравномерные данные) или справа уже найдено равное значение (группа
+// дубликатов), делается шаг бинарного поиска, так что хуже O(log n) не бывает
+template<typename RandomIt, typename T, typename Projection = identity_projection>
+RandomIt interpolation_lower_bound_by(RandomIt first, RandomIt last, const T& value, Projection proj = {}) {
+	auto n = last - first;
+	if (n == 0 || !(proj(first[0]) < value)) return first;
+	if (proj(first[n - 1]) < value) return last;
+
+	// Ответ в (bot, top]: ключ в bot меньше искомого, в top - не меньше
+	decltype(n) bot = 0;
+	decltype(n) top = n - 1;
+	double bot_value = static_cast<double>(proj(first[bot]));
+	double top_value = static_cast<double>(proj(first[top]));
+	const double target = static_cast<double>(value);
+
+	auto probe = [&](decltype(n) pos) {
+		auto pos_value = proj(first[pos]);
+		if (pos_value < value) {
+			bot = pos;
+			bot_value = static_cast<double>(pos_value);
+		}
+		else {
+			top = pos;
+			top_value = static_cast<double>(pos_value);
+		}
+	};
+
+	while (top - bot > 1) {
+		auto size = top - bot;
+		if (top_value != target) {
+			// bot_value < target < top_value, поэтому доля в (0, 1)
+			double fraction = (target - bot_value) / (top_value - bot_value);
+			auto pos = bot + static_cast<decltype(n)>(fraction * static_cast<double>(size));
+			probe(min(max(pos, bot + 1), top - 1));
+		}
+		if (top - bot > size / 2 && top - bot > 1) {
+			probe(bot + (top - bot) / 2);
+		}
+	}
+	return first + top;
+}
+
 template<typename T, typename Getter>
 vector<flight> linear_search(const vector<flight>& flights, Getter getter, const T& searched_elem) {
 	vector<flight> result;
@@ -20,93 +194,497 @@ vector<flight> linear_search(const vector<flight>& flights, Getter getter, const
 	return result;
 }
 
+// Все записи с getter(flight) == searched_elem в порядке вектора
 template<typename T, typename Getter>
 vector<flight> binary_search(const vector<flight>& flights, Getter getter, const T& searched_elem) { // only works for sorted flights
-	vector<flight> result;
+	auto range = equal_range_by(flights.begin(), flights.end(), searched_elem, getter);
+	return vector<flight>(range.first, range.second);
+}
+
+template<typename T, typename Getter>
+vector<flight> Fibonacci_search(const vector<flight>& flights, Getter getter, const T& searched_elem) { //only works for sorted vectors
+	auto range = fibonacci_equal_range_by(flights.begin(), flights.end(), searched_elem, getter);
+	return vector<flight>(range.first, range.second);
+}
+
+// Диапазон индексов [first, last) в отсортированном векторе: результат поиска без копирования записей
+struct IndexRange {
+	size_t first = 0;
+	size_t last = 0;
+
+	size_t size() const { return last - first; }
+	bool empty() const { return first == last; }
+};
+
+// Легкое представление записей диапазона (указатели в исходный вектор)
+struct FlightRange {
+	const flight* first = nullptr;
+	const flight* last = nullptr;
+
+	const flight* begin() const { return first; }
+	const flight* end() const { return last; }
+	size_t size() const { return static_cast<size_t>(last - first); }
+	bool empty() const { return first == last; }
+	const flight& operator[](size_t i) const { return first[i]; }
+};
 
-	int bot = 0;
-	int top = static_cast<int>(flights.size() - 1);
-	while (bot <= top) {
+inline FlightRange make_flight_range(const vector<flight>& flights, IndexRange range) {
+	return { flights.data() + range.first, flights.data() + range.last };
+}
 
-		int mid = bot + (top - bot) / 2;
+// Первая позиция в [bot, top), где getter(flight) >= searched_elem
+template<typename T, typename Getter>
+size_t lower_bound_index(const vector<flight>& flights, Getter getter, const T& searched_elem,
+	size_t bot = 0, size_t top = static_cast<size_t>(-1)) {
+	top = min(top, flights.size());
+	if (bot >= top) return bot;
+	return static_cast<size_t>(lower_bound_by(flights.begin() + bot, flights.begin() + top, searched_elem, getter) - flights.begin());
+}
 
-		auto midVal = getter(flights[mid]);
-		if (mid < 0 || mid >= flights.size()) {
-			break;
+// Первая позиция в [bot, top), где getter(flight) > searched_elem
+template<typename T, typename Getter>
+size_t upper_bound_index(const vector<flight>& flights, Getter getter, const T& searched_elem,
+	size_t bot = 0, size_t top = static_cast<size_t>(-1)) {
+	top = min(top, flights.size());
+	if (bot >= top) return bot;
+	return static_cast<size_t>(upper_bound_by(flights.begin() + bot, flights.begin() + top, searched_elem, getter) - flights.begin());
+}
+
+// Все записи с getter(flight) == searched_elem за O(log n) независимо от их числа
+template<typename T, typename Getter>
+IndexRange equal_range_search(const vector<flight>& flights, Getter getter, const T& searched_elem) { // only works for sorted flights
+	size_t first = lower_bound_index(flights, getter, searched_elem);
+	size_t last = upper_bound_index(flights, getter, searched_elem, first);
+	return { first, last };
+}
+
+// Fibonacci поиск находит одно совпадение, границы диапазона уточняются бинарным поиском
+template<typename T, typename Getter>
+IndexRange Fibonacci_search_range(const vector<flight>& flights, Getter getter, const T& searched_elem) { //only works for sorted vectors
+	auto range = fibonacci_equal_range_by(flights.begin(), flights.end(), searched_elem, getter);
+	return { static_cast<size_t>(range.first - flights.begin()), static_cast<size_t>(range.second - flights.begin()) };
+}
+
+// Линейный поиск по несортированному вектору: индексы совпадений вместо копий записей
+template<typename T, typename Getter>
+vector<size_t> linear_search_indices(const vector<flight>& flights, Getter getter, const T& searched_elem) {
+	vector<size_t> result;
+	for (size_t i = 0; i < flights.size(); ++i)
+	{
+		if (getter(flights[i]) == searched_elem)
+		{
+			result.push_back(i);
 		}
-		if (midVal == searched_elem) {
-			int i = mid;
-			while (i >= 0 && getter(flights[i]) == searched_elem)
+	}
+
+	return result;
+}
+
+// Линейный поиск по столбцу (см. column_scan.h, extract_column): значения сравниваются
+// векторно по 8 за инструкцию, результат - индексы совпадений
+inline vector<size_t> linear_search(const vector<float>& column, float searched_elem) {
+	vector<size_t> result;
+	column_select(column.data(), column.size(), ColumnPredicate::Equal, searched_elem, searched_elem, result);
+	return result;
+}
+
+inline vector<size_t> linear_search(const vector<int32_t>& column, int32_t searched_elem) {
+	vector<size_t> result;
+	column_select(column.data(), column.size(), ColumnPredicate::Equal, searched_elem, searched_elem, result);
+	return result;
+}
+
+// Значения из отрезка [lo, hi]
+inline vector<size_t> linear_search_between(const vector<float>& column, float lo, float hi) {
+	vector<size_t> result;
+	column_select(column.data(), column.size(), ColumnPredicate::Between, lo, hi, result);
+	return result;
+}
+
+inline vector<size_t> linear_search_between(const vector<int32_t>& column, int32_t lo, int32_t hi) {
+	vector<size_t> result;
+	column_select(column.data(), column.size(), ColumnPredicate::Between, lo, hi, result);
+	return result;
+}
+
+// Меньше стольких записей на поток параллельный поиск не окупается и остается последовательным
+const size_t PARALLEL_SEARCH_MIN_PER_THREAD = 32768;
+
+// Число частей для параллельного поиска по n записям (1 - последовательно)
+inline size_t parallel_search_parts(size_t n, size_t threads) {
+	if (threads == 0) threads = ThreadPool::shared().size();
+	return max<size_t>(1, min(threads, n / PARALLEL_SEARCH_MIN_PER_THREAD));
+}
+
+// Параллельный линейный поиск: вход делится на куски по потокам общего пула,
+// каждый кусок собирает совпадения в свой буфер, буферы склеиваются по порядку входа,
+// поэтому результат совпадает с linear_search. threads = 0 - размер пула.
+// Нельзя вызывать из задачи, выполняемой в общем пуле
+template<typename T, typename Getter>
+vector<flight> parallel_linear_search(const vector<flight>& flights, Getter getter, const T& searched_elem, size_t threads = 0) {
+	size_t parts = parallel_search_parts(flights.size(), threads);
+	if (parts <= 1) {
+		return linear_search(flights, getter, searched_elem);
+	}
+
+	vector<vector<flight>> found(parts);
+	parallel_for_chunks(ThreadPool::shared(), flights.size(), parts, [&](size_t part, size_t begin, size_t end) {
+		vector<flight>& local = found[part];
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (getter(flights[i]) == searched_elem)
 			{
-				result.push_back(flights[i]);
-				i--;
+				local.push_back(flights[i]);
 			}
-			i = mid + 1;
-			while (i < flights.size() && getter(flights[i]) == searched_elem)
+		}
+	});
+
+	size_t total = 0;
+	for (const auto& local : found) total += local.size();
+	vector<flight> result;
+	result.reserve(total);
+	for (auto& local : found) {
+		move(local.begin(), local.end(), back_inserter(result));
+	}
+	return result;
+}
+
+template<typename T, typename Getter>
+vector<size_t> parallel_linear_search_indices(const vector<flight>& flights, Getter getter, const T& searched_elem, size_t threads = 0) {
+	size_t parts = parallel_search_parts(flights.size(), threads);
+	if (parts <= 1) {
+		return linear_search_indices(flights, getter, searched_elem);
+	}
+
+	vector<vector<size_t>> found(parts);
+	parallel_for_chunks(ThreadPool::shared(), flights.size(), parts, [&](size_t part, size_t begin, size_t end) {
+		vector<size_t>& local = found[part];
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (getter(flights[i]) == searched_elem)
 			{
-				result.push_back(flights[i]);
-				i++;
+				local.push_back(i);
 			}
-			return result;
-		}
-		if (midVal < searched_elem) {
-			bot = mid + 1;
-		}
-		if (midVal > searched_elem) {
-			top = mid - 1;
 		}
+	});
+
+	size_t total = 0;
+	for (const auto& local : found) total += local.size();
+	vector<size_t> result;
+	result.reserve(total);
+	for (const auto& local : found) {
+		result.insert(result.end(), local.begin(), local.end());
 	}
 	return result;
 }
 
+// Branchless lower_bound по отсортированному столбцу: на каждом шаге диапазон
+// уменьшается вдвое без условного перехода (сравнение компилируется в cmov)
+template<typename Key>
+size_t branchless_lower_bound(const vector<Key>& sorted_keys, const Key& searched_elem) {
+	size_t len = sorted_keys.size();
+	if (len == 0) return 0;
+	const Key* base = sorted_keys.data();
+	while (len > 1) {
+		size_t half = len / 2;
+		base += (base[half - 1] < searched_elem) ? half : 0;
+		len -= half;
+	}
+	return static_cast<size_t>(base - sorted_keys.data()) + (*base < searched_elem ? 1 : 0);
+}
+
+// Позиции 0..n (n - граница пустого диапазона в конце) должны помещаться в Index
+template<typename Index>
+void check_index_range(size_t n, const char* owner) {
+	if (n > static_cast<size_t>(numeric_limits<Index>::max())) {
+		throw length_error(string(owner) + ": too many keys for the Index type");
+	}
+}
+
+// Отсортированные ключи в порядке Эйтцингера (обход дерева поиска в ширину):
+// потомки узла k - узлы 2k и 2k + 1, поэтому первые уровни дерева лежат в нескольких
+// кэш-линиях, а узлы на 4 уровня вперед подгружаются заранее (prefetch).
+// Поиск возвращает позицию в исходном отсортированном массиве.
+// Index - тип хранимых позиций; uint32_t вдвое экономнее, но вмещает меньше 2^32 ключей,
+// и build для большего массива бросает length_error
+template<typename Key, typename Index = size_t>
+class EytzingerIndex {
+public:
+	EytzingerIndex() = default;
+	explicit EytzingerIndex(const vector<Key>& sorted_keys) { build(sorted_keys); }
+
+	void build(const vector<Key>& sorted_keys) {
+		check_index_range<Index>(sorted_keys.size(), "EytzingerIndex");
+		n = sorted_keys.size();
+		tree.assign(n + 1, Key());
+		positions.assign(n + 1, 0);
+		size_t next = 0;
+		fill(sorted_keys, next, 1);
+	}
+
+	// Первая позиция с ключом >= searched_elem (n, если такой нет)
+	size_t lower_bound(const Key& searched_elem) const {
+		return descend([&](const Key& key) { return key < searched_elem; });
+	}
+
+	// Первая позиция с ключом > searched_elem
+	size_t upper_bound(const Key& searched_elem) const {
+		return descend([&](const Key& key) { return !(searched_elem < key); });
+	}
+
+	IndexRange equal_range(const Key& searched_elem) const {
+		return { lower_bound(searched_elem), upper_bound(searched_elem) };
+	}
+
+	size_t size() const { return n; }
+	size_t memory_bytes() const { return tree.capacity() * sizeof(Key) + positions.capacity() * sizeof(Index); }
+
+private:
+	// Узлов одного уровня в кэш-линии: prefetch узла 16k загружает всех потомков k на 4 уровня ниже
+	static constexpr size_t PREFETCH_STRIDE = 64 / sizeof(Key) > 0 ? 64 / sizeof(Key) : 1;
+
+	void fill(const vector<Key>& sorted_keys, size_t& next, size_t k) {
+		if (k > n) return;
+		fill(sorted_keys, next, 2 * k);
+		tree[k] = sorted_keys[next];
+		positions[k] = static_cast<Index>(next);
+		next++;
+		fill(sorted_keys, next, 2 * k + 1);
+	}
+
+	// Спуск без ветвлений: go_right(key) выбирает правого потомка.
+	// После выхода за лист номер узла ответа получается отбрасыванием
+	// младших единиц (поворотов направо) и одного нуля
+	template<typename GoRight>
+	size_t descend(GoRight go_right) const {
+		size_t k = 1;
+		while (k <= n) {
+			__builtin_prefetch(tree.data() + min(k * PREFETCH_STRIDE, n));
+			k = 2 * k + (go_right(tree[k]) ? 1 : 0);
+		}
+		k >>= __builtin_ffsll(static_cast<long long>(~k));
+		return k == 0 ? n : positions[k];
+	}
+
+	size_t n = 0;
+	vector<Key> tree;
+	vector<Index> positions;
+};
+
+// Первая позиция в [from, n) с getter(flight) > searched_elem, галопом от from
+// (см. gallop_upper_bound_by). O(log k), где k - число равных записей
+template<typename T, typename Getter>
+size_t gallop_upper_bound(const vector<flight>& flights, Getter getter, const T& searched_elem, size_t from) {
+	from = min(from, flights.size());
+	return static_cast<size_t>(gallop_upper_bound_by(flights.begin() + from, flights.end(), searched_elem, getter) - flights.begin());
+}
+
+// Первая позиция в [from, n) с getter(flight) >= searched_elem, галопом от from.
+// O(log d), где d - расстояние от from до ответа
 template<typename T, typename Getter>
-vector<flight> Fibonacci_search(const vector<flight>& flights, Getter getter, const T& searched_elem) { //only works for sorted vectors
-	vector<flight> result;
-	int n = flights.size();
+size_t gallop_lower_bound(const vector<flight>& flights, Getter getter, const T& searched_elem, size_t from) {
+	from = min(from, flights.size());
+	return static_cast<size_t>(gallop_lower_bound_by(flights.begin() + from, flights.end(), searched_elem, getter) - flights.begin());
+}
 
-	int a = 0, b = 0, c = 1;
-	while (c < n) {
-		a = b;
-		b = c;
-		c = a + b;
+// Интерполяционный поиск нижней границы (см. interpolation_lower_bound_by)
+template<typename T, typename Getter>
+size_t interpolation_lower_bound(const vector<flight>& flights, Getter getter, const T& searched_elem) {
+	return static_cast<size_t>(interpolation_lower_bound_by(flights.begin(), flights.end(), searched_elem, getter) - flights.begin());
+}
+
+template<typename T, typename Getter>
+IndexRange interpolation_search_range(const vector<flight>& flights, Getter getter, const T& searched_elem) { // only works for sorted flights
+	size_t first = interpolation_lower_bound(flights, getter, searched_elem);
+	return { first, gallop_upper_bound(flights, getter, searched_elem, first) };
+}
+
+template<typename T, typename Getter>
+vector<flight> interpolation_search(const vector<flight>& flights, Getter getter, const T& searched_elem) { // only works for sorted flights
+	IndexRange range = interpolation_search_range(flights, getter, searched_elem);
+	return vector<flight>(flights.begin() + range.first, flights.begin() + range.last);
+}
+
+// Экспоненциальный (галопирующий) поиск: граница удваивается от начала, пока значение
+// меньше искомого, затем бинарный поиск в последнем интервале. O(log i), где i - позиция
+// ответа: выгоден, когда искомое близко к началу
+template<typename T, typename Getter>
+size_t exponential_lower_bound(const vector<flight>& flights, Getter getter, const T& searched_elem) {
+	return gallop_lower_bound(flights, getter, searched_elem, 0);
+}
+
+template<typename T, typename Getter>
+IndexRange exponential_search_range(const vector<flight>& flights, Getter getter, const T& searched_elem) { // only works for sorted flights
+	size_t first = exponential_lower_bound(flights, getter, searched_elem);
+	return { first, gallop_upper_bound(flights, getter, searched_elem, first) };
+}
+
+template<typename T, typename Getter>
+vector<flight> exponential_search(const vector<flight>& flights, Getter getter, const T& searched_elem) { // only works for sorted flights
+	IndexRange range = exponential_search_range(flights, getter, searched_elem);
+	return vector<flight>(flights.begin() + range.first, flights.begin() + range.last);
+}
+
+// Пакетный поиск: запросы сортируются, и записи проходятся один раз слева направо,
+// как при слиянии: граница каждого следующего запроса ищется галопом от границы
+// предыдущего. O(q log q + q log(n / q)) вместо q полных бинарных поисков, а соседние
+// пробы попадают в уже загруженные кэш-линии. result[i] - ответ на queries[i],
+// как у equal_range_search (для промаха - пустой диапазон в позиции вставки)
+template<typename T, typename Getter>
+vector<IndexRange> batch_equal_range_search(const vector<flight>& flights, Getter getter, const vector<T>& queries) { // only works for sorted flights
+	vector<size_t> order(queries.size());
+	iota(order.begin(), order.end(), size_t{ 0 });
+	sort(order.begin(), order.end(), [&](size_t a, size_t b) { return queries[a] < queries[b]; });
+
+	vector<IndexRange> result(queries.size());
+	size_t cursor = 0;
+	for (size_t k = 0; k < order.size(); ++k) {
+		const T& searched_elem = queries[order[k]];
+		// Повторный запрос того же значения
+		if (k > 0 && !(queries[order[k - 1]] < searched_elem)) {
+			result[order[k]] = result[order[k - 1]];
+			continue;
+		}
+		size_t first = gallop_lower_bound(flights, getter, searched_elem, cursor);
+		size_t last = gallop_upper_bound(flights, getter, searched_elem, first);
+		result[order[k]] = { first, last };
+		cursor = last;
 	}
+	return result;
+}
 
-	int elim = -1;
+// Сколько запросов batch_lower_bound ведет одновременно
+const size_t BATCH_SEARCH_GROUP = 16;
 
-	while (c > 1) {
-		int i = min(elim + a, n - 1);
-		auto iVal = getter(flights[i]);
-		if (iVal < searched_elem) {
-			c = b;
-			b = a;
-			a = c - b;
-			elim = i;
+// Пакетный lower_bound по отсортированному столбцу: бинарные поиски группы запросов
+// идут шаг в шаг (длина окна у всех одинакова), и пока выполняется шаг одного
+// запроса, обе возможные следующие пробы остальных уже подгружаются (prefetch).
+// Задержки промахов кэша перекрываются, а не складываются. result[i] = branchless_lower_bound(sorted_keys, queries[i])
+template<typename Key>
+vector<size_t> batch_lower_bound(const vector<Key>& sorted_keys, const vector<Key>& queries) {
+	vector<size_t> result(queries.size(), 0);
+	if (sorted_keys.empty()) return result;
+
+	const Key* keys = sorted_keys.data();
+	size_t base[BATCH_SEARCH_GROUP];
+	for (size_t start = 0; start < queries.size(); start += BATCH_SEARCH_GROUP) {
+		size_t group = min(BATCH_SEARCH_GROUP, queries.size() - start);
+		const Key* q = queries.data() + start;
+		fill(base, base + group, size_t{ 0 });
+
+		size_t len = sorted_keys.size();
+		while (len > 1) {
+			size_t half = len / 2;
+			size_t next_half = (len - half) / 2;
+			for (size_t j = 0; j < group; ++j) {
+				if (next_half > 0) {
+					__builtin_prefetch(keys + base[j] + next_half - 1);
+					__builtin_prefetch(keys + base[j] + half + next_half - 1);
+				}
+				base[j] += (keys[base[j] + half - 1] < q[j]) ? half : 0;
+			}
+			len -= half;
+		}
+		for (size_t j = 0; j < group; ++j) {
+			result[start + j] = base[j] + (keys[base[j]] < q[j] ? 1 : 0);
 		}
+	}
+	return result;
+}
 
-		else if (iVal > searched_elem) {
-			c = a;
-			b = b - a;
-			a = c - b;
+// Хеш-индекс по отсортированному столбцу: различный ключ -> диапазон его позиций.
+// Открытая адресация с линейным пробированием в плоском массиве (заполнение <= 1/2),
+// слот определяется умножением хеша на константу Фибоначчи, поэтому
+// последовательные целые ключи не скапливаются в соседних слотах.
+// find_batch сначала считает хеши группы запросов и подгружает их слоты,
+// затем сравнивает ключи - промахи кэша группы идут параллельно. Простой цикл
+// find по независимым ключам процессор перекрывает и сам, поэтому выигрыш заметен,
+// когда между поисками есть другая работа. Index - тип границ диапазонов, как у EytzingerIndex
+template<typename Key, typename Index = size_t>
+class KeyHashIndex {
+public:
+	KeyHashIndex() = default;
+	explicit KeyHashIndex(const vector<Key>& sorted_keys) { build(sorted_keys); }
+
+	void build(const vector<Key>& sorted_keys) {
+		check_index_range<Index>(sorted_keys.size(), "KeyHashIndex");
+		n = sorted_keys.size();
+		distinct = 0;
+		for (size_t i = 0; i < n; ++i) {
+			if (i == 0 || sorted_keys[i - 1] < sorted_keys[i]) distinct++;
 		}
-		else {
-			int i1 = i;
-			auto finVal = getter(flights[i1]);
-			while (i1 >= 0 && getter(flights[i1]) == searched_elem)
-			{
+		shift = 64;
+		size_t capacity = 1;
+		while (capacity < 2 * distinct + 2) {
+			capacity *= 2;
+			shift--;
+		}
+		mask = capacity - 1;
+		slots.assign(capacity, Slot());
 
-				result.push_back(flights[i1]);
-				i1--;
+		for (size_t first = 0; first < n;) {
+			size_t last = first + 1;
+			while (last < n && !(sorted_keys[first] < sorted_keys[last])) last++;
+			// NaN не равен сам себе и никогда не будет найден
+			if (sorted_keys[first] == sorted_keys[first]) {
+				size_t slot = home_slot(sorted_keys[first]);
+				while (slots[slot].used) slot = (slot + 1) & mask;
+				slots[slot] = { sorted_keys[first], static_cast<Index>(first), static_cast<Index>(last), true };
 			}
-			i1 = i + 1;
-			while (i1 < flights.size() && getter(flights[i1]) == searched_elem)
-			{
+			first = last;
+		}
+	}
 
-				result.push_back(flights[i1]);
-				i1++;
+	// Позиции ключа в исходном столбце; пустой диапазон, если ключа нет
+	IndexRange find(const Key& key) const {
+		return probe(home_slot(key), key);
+	}
+
+	vector<IndexRange> find_batch(const vector<Key>& keys) const {
+		vector<IndexRange> result(keys.size());
+		size_t home[BATCH_SEARCH_GROUP];
+		for (size_t start = 0; start < keys.size(); start += BATCH_SEARCH_GROUP) {
+			size_t group = min(BATCH_SEARCH_GROUP, keys.size() - start);
+			for (size_t j = 0; j < group; ++j) {
+				home[j] = home_slot(keys[start + j]);
+				__builtin_prefetch(slots.data() + home[j]);
+			}
+			for (size_t j = 0; j < group; ++j) {
+				result[start + j] = probe(home[j], keys[start + j]);
 			}
-			return result;
+		}
+		return result;
+	}
+
+	size_t size() const { return n; }
+	size_t distinct_count() const { return distinct; }
+	size_t memory_bytes() const { return slots.capacity() * sizeof(Slot); }
 
+private:
+	struct Slot {
+		Key key = Key();
+		Index first = 0;
+		Index last = 0;
+		bool used = false;
+	};
+
+	size_t home_slot(const Key& key) const {
+		uint64_t h = static_cast<uint64_t>(hash<Key>()(key)) * 0x9E3779B97F4A7C15ULL;
+		return shift >= 64 ? 0 : static_cast<size_t>(h >> shift);
+	}
+
+	IndexRange probe(size_t slot, const Key& key) const {
+		if (slots.empty()) return {};
+		while (slots[slot].used) {
+			if (slots[slot].key == key) return { slots[slot].first, slots[slot].last };
+			slot = (slot + 1) & mask;
 		}
+		return {};
 	}
-	return result;
-}
+
+	size_t n = 0;
+	size_t distinct = 0;
+	size_t mask = 0;
+	unsigned shift = 64;
+	vector<Slot> slots;
+};
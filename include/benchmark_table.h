@@ -0,0 +1,28 @@
+#ifndef DATASETREADING_BENCHMARK_TABLE_H
+#define DATASETREADING_BENCHMARK_TABLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Общие функции таблиц SortBenchmark и SearchBenchmark
+
+// Ячейка таблицы шириной width символов (setw считает байты, а кириллица в UTF-8 - по 2 байта)
+inline std::string cell(const std::string& text, size_t width) {
+    size_t chars = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) chars++;
+    }
+    return text + std::string(width > chars ? width - chars : 1, ' ');
+}
+
+// Перцентиль p (0..1) методом ближайшего ранга; для пустого набора 0
+inline double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+    return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+#endif //DATASETREADING_BENCHMARK_TABLE_H
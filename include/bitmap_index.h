@@ -0,0 +1,101 @@
+#ifndef DATASETREADING_BITMAP_INDEX_H
+#define DATASETREADING_BITMAP_INDEX_H
+
+#include "flight.h"
+#include "flight_containers.h"
+#include <cstdint>
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+// Сжатый битовый набор номеров строк в стиле Roaring.
+// Номера делятся на блоки по 2^16 (старшие 16 бит - ключ блока).
+// Разреженный блок (до 4096 значений) хранится отсортированным массивом uint16_t,
+// плотный - 1024 словами по 64 бита; операции над плотными блоками идут пословно.
+class RoaringBitmap {
+public:
+    void add(uint32_t row);
+    bool contains(uint32_t row) const;
+    size_t cardinality() const;
+    bool empty() const { return containers.empty(); }
+
+    RoaringBitmap operator&(const RoaringBitmap& other) const;
+    RoaringBitmap operator|(const RoaringBitmap& other) const;
+    // Разность множеств: строки из this, которых нет в other
+    RoaringBitmap and_not(const RoaringBitmap& other) const;
+    // Дополнение до диапазона [0, universe)
+    RoaringBitmap complement(uint32_t universe) const;
+
+    std::vector<uint32_t> to_rows() const;
+
+    // Фактический объем хранимых данных (без служебных полей вектора)
+    size_t memory_bytes() const;
+
+private:
+    static const size_t WORDS = 1024;          // 2^16 бит
+    static const size_t ARRAY_LIMIT = 4096;    // порог перехода массив -> битовая карта
+
+    struct Container {
+        uint16_t key{};
+        uint32_t cardinality{};
+        std::vector<uint16_t> array;    // используется, если words пуст
+        std::vector<uint64_t> words;
+
+        bool is_dense() const { return !words.empty(); }
+        void to_words(std::vector<uint64_t>& out) const;
+        void normalize();
+    };
+
+    Container* find_container(uint16_t key);
+    const Container* find_container(uint16_t key) const;
+
+    static Container intersect(const Container& a, const Container& b);
+    static Container unite(const Container& a, const Container& b);
+    static Container subtract(const Container& a, const Container& b);
+
+    std::vector<Container> containers;    // упорядочены по key
+};
+
+enum class FlightFlag {
+    Canceled,
+    Diverted,
+    CarrierDelay,
+    WeatherDelay,
+    NasDelay,
+    SecurityDelay,
+    LateAircraftDelay
+};
+
+// Битовые индексы по столбцам с малым числом значений.
+// Строка индекса - позиция рейса в порядке обхода контейнера при построении.
+// Вставки после построения в индекс не попадают: его нужно построить заново.
+class FlightBitmapIndex {
+public:
+    void build(const FlightUnorderedSet& flights);
+    void clear();
+
+    const RoaringBitmap& by_flag(FlightFlag flag) const;
+    const RoaringBitmap& by_cancellation_code(char code) const;
+    const RoaringBitmap& by_week_day(int week_day) const;
+    const RoaringBitmap& by_month(int month) const;
+
+    // NOT относительно всех проиндексированных строк
+    RoaringBitmap negate(const RoaringBitmap& bitmap) const;
+
+    const flight* get_row(uint32_t row) const { return rows[row]; }
+    std::vector<const flight*> get_flights(const RoaringBitmap& bitmap) const;
+    size_t size() const { return rows.size(); }
+
+    size_t memory_bytes() const;
+
+private:
+    static const RoaringBitmap& lookup(const std::map<int, RoaringBitmap>& column, int value);
+
+    std::vector<const flight*> rows;
+    std::vector<RoaringBitmap> flags;
+    std::map<int, RoaringBitmap> cancellation_codes;
+    std::map<int, RoaringBitmap> week_days;
+    std::map<int, RoaringBitmap> months;
+};
+
+#endif //DATASETREADING_BITMAP_INDEX_H
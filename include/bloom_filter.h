@@ -0,0 +1,46 @@
+#ifndef DATASETREADING_BLOOM_FILTER_H
+#define DATASETREADING_BLOOM_FILTER_H
+
+#include "flight.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Блочный фильтр Блума: приблизительная проверка принадлежности множеству.
+// might_contain == false - ключа точно нет; true - ключ есть или ложное срабатывание.
+// Все биты одного ключа лежат в одном блоке из 512 бит (кэш-линия), поэтому
+// проверка стоит одного промаха кэша. Размер подбирается по ожидаемому числу
+// ключей и доле ложных срабатываний; при переполнении сверх ожидаемого доля растет,
+// но ложных отрицаний не бывает никогда.
+class BloomFilter {
+public:
+    BloomFilter() = default;
+    BloomFilter(size_t expected_items, double false_positive_rate);
+
+    void add(uint64_t hash);
+    bool might_contain(uint64_t hash) const;
+
+    bool empty() const { return blocks == 0; }
+    void clear();
+
+    size_t get_items() const { return items; }
+    unsigned get_hash_count() const { return hash_count; }
+    size_t memory_bytes() const { return words.capacity() * sizeof(uint64_t); }
+    // Ожидаемая доля ложных срабатываний при текущем заполнении
+    double estimated_false_positive_rate() const;
+
+private:
+    static const size_t BLOCK_WORDS = 8;    // 512 бит
+
+    size_t blocks = 0;
+    unsigned hash_count = 0;
+    size_t items = 0;
+    std::vector<uint64_t> words;
+};
+
+// Хеш уникального ключа рейса (формат get_unique_key). Для записи ключ собирается
+// в буфер потока без выделения памяти; результат совпадает с хешем строки ключа
+uint64_t flight_key_hash(std::string_view unique_key);
+uint64_t flight_key_hash(const flight& f);
+
+#endif //DATASETREADING_BLOOM_FILTER_H
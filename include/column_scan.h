@@ -0,0 +1,53 @@
+#ifndef DATASETREADING_COLUMN_SCAN_H
+#define DATASETREADING_COLUMN_SCAN_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "flight.h"
+
+// Сканирование плотных столбцов (float, int32), извлеченных из записей.
+// На x86 с AVX2 используется векторная версия (8 значений за сравнение,
+// выбор во время выполнения), иначе - скалярная.
+
+// Условие отбора значения v. Для Between границы включаются: a <= v <= b.
+// NaN не проходит ни одно условие
+enum class ColumnPredicate {
+    Equal,          // v == a
+    Less,           // v < a
+    GreaterEqual,   // v >= a
+    Between         // a <= v <= b
+};
+
+// Столбец из записей: values[i] = getter(flights[i])
+template<typename Getter>
+auto extract_column(const std::vector<flight>& flights, Getter getter)
+    -> std::vector<std::decay_t<std::invoke_result_t<Getter, const flight&>>> {
+    std::vector<std::decay_t<std::invoke_result_t<Getter, const flight&>>> values(flights.size());
+    for (size_t i = 0; i < flights.size(); ++i) {
+        values[i] = getter(flights[i]);
+    }
+    return values;
+}
+
+// Столбец задержек прибытия: values[i] = flights[i].get_arr_delay()
+std::vector<float> extract_arr_delay(const std::vector<flight>& flights);
+
+// Дописывают в out индексы подходящих значений, возвращают число добавленных
+size_t column_select(const float* values, size_t n, ColumnPredicate op, float a, float b,
+                     std::vector<size_t>& out);
+size_t column_select(const int32_t* values, size_t n, ColumnPredicate op, int32_t a, int32_t b,
+                     std::vector<size_t>& out);
+
+// Битовая маска отбора: бит i % 64 слова i / 64 установлен, если values[i] подходит
+std::vector<uint64_t> column_mask(const float* values, size_t n, ColumnPredicate op, float a, float b);
+std::vector<uint64_t> column_mask(const int32_t* values, size_t n, ColumnPredicate op, int32_t a, int32_t b);
+
+inline size_t select_greater_equal(const float* values, size_t n, float threshold, std::vector<size_t>& out) {
+    return column_select(values, n, ColumnPredicate::GreaterEqual, threshold, threshold, out);
+}
+
+// Используется ли векторная версия на этой машине
+bool column_scan_uses_avx2();
+
+#endif //DATASETREADING_COLUMN_SCAN_H
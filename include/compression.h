@@ -41,8 +41,9 @@ private:
 
         uint32_t hash = calculateHash(data, current_pos);
 
-        size_t window_start = (current_pos > WINDOW_SIZE) ?
-                              current_pos - WINDOW_SIZE : 0;
+        // Смещение кодируется 12 битами, поэтому максимум WINDOW_SIZE - 1
+        size_t window_start = (current_pos >= WINDOW_SIZE) ?
+                              current_pos - WINDOW_SIZE + 1 : 0;
 
         auto it = hash_table.find(hash);
         if (it != hash_table.end()) {
@@ -0,0 +1,96 @@
+#ifndef DATASETREADING_CONCURRENT_FLIGHT_ORGANIZER_H
+#define DATASETREADING_CONCURRENT_FLIGHT_ORGANIZER_H
+
+#include "flight.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Вариант FlightOrganizer для многопоточного обслуживания запросов.
+// Данные хранятся в неизменяемых сегментах; писатель (один поток) копит новые
+// рейсы и публикует их новым снимком (список сегментов) с новым номером версии
+// (RCU: старый снимок живет, пока его держит хотя бы один читатель).
+// Каждый поток-читатель хранит shared_ptr на снимок в своем кэше (thread_local)
+// и на каждом запросе только сверяет номер версии - одна атомарная загрузка, без
+// блокировок и без записи в общую память (счетчик ссылок не трогается).
+// Первый запрос потока после публикации копирует новый shared_ptr под publish_mutex;
+// писатель держит его только на время обмена указателей, а сборка и слияние
+// сегментов идут вне блокировки. Кэш потока удерживает последний прочитанный снимок,
+// пока поток не обратится к организатору снова, не перейдет к другому организатору
+// или не завершится.
+class ConcurrentFlightOrganizer {
+public:
+    // Неизменяемая часть данных со своими индексами
+    struct Segment {
+        std::vector<flight> flights;
+        std::unordered_map<std::string, uint32_t> by_key;
+        std::unordered_map<std::string, std::vector<uint32_t>> by_carrier;
+        std::unordered_map<std::string, std::vector<uint32_t>> by_aircraft;
+
+        explicit Segment(std::vector<flight> data);
+    };
+
+    // Согласованное состояние на момент публикации
+    class Snapshot {
+    public:
+        size_t get_unique_flights_count() const { return total; }
+        size_t get_segment_count() const { return segments.size(); }
+        bool contains(const std::string& key) const;
+        const flight* find(const std::string& key) const;
+        std::vector<const flight*> get_flights_by_carrier(const std::string& carrier_id) const;
+        std::vector<const flight*> get_flights_by_aircraft(const std::string& carrier_id, float flight_number) const;
+
+    private:
+        friend class ConcurrentFlightOrganizer;
+        std::vector<std::shared_ptr<const Segment>> segments;
+        size_t total = 0;
+    };
+
+    explicit ConcurrentFlightOrganizer(size_t publish_batch = 4096);
+    ~ConcurrentFlightOrganizer();
+    ConcurrentFlightOrganizer(const ConcurrentFlightOrganizer&) = delete;
+    ConcurrentFlightOrganizer& operator=(const ConcurrentFlightOrganizer&) = delete;
+
+    // --- Писатель ---
+    // Возвращает false для дубликата. Рейс становится виден читателям после publish()
+    // (вызывается автоматически каждые publish_batch новых рейсов)
+    bool add_flight(const flight& f);
+    void publish();
+
+    // --- Читатели ---
+    std::shared_ptr<const Snapshot> snapshot() const;
+    // Число опубликованных снимков
+    uint64_t get_version() const { return version.load(std::memory_order_acquire); }
+    size_t get_unique_flights_count() const;
+    bool contains(const std::string& key) const;
+    std::vector<flight> get_flights_by_carrier(const std::string& carrier_id) const;
+    std::vector<flight> get_flights_by_aircraft(const std::string& carrier_id, float flight_number) const;
+
+private:
+    // Вызывается под writer_mutex
+    void publish_pending();
+    // Снимок из кэша потока, обновленный при смене версии
+    const std::shared_ptr<const Snapshot>& cached_snapshot() const;
+
+    static std::string aircraft_key(const std::string& carrier_id, float flight_number);
+    static std::vector<flight> copy_flights(const std::vector<const flight*>& pointers);
+
+    // Различает организаторы в кэшах потоков (адрес может быть занят заново)
+    const uint64_t instance_id;
+    std::atomic<uint64_t> version{0};
+    mutable std::mutex publish_mutex;
+    std::shared_ptr<const Snapshot> current;    // пишется под publish_mutex
+
+    // Состояние писателя; читатели его не трогают
+    std::mutex writer_mutex;
+    std::unordered_set<std::string> known_keys;
+    std::vector<flight> pending;
+    size_t publish_batch;
+};
+
+#endif //DATASETREADING_CONCURRENT_FLIGHT_ORGANIZER_H
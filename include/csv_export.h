@@ -0,0 +1,76 @@
+#ifndef DATASETREADING_CSV_EXPORT_H
+#define DATASETREADING_CSV_EXPORT_H
+
+#include "flight.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Способ записи CSV
+enum class CsvWriteMode {
+    Stream,     // ofstream << по каждому полю (исходный вариант)
+    Buffered,   // форматирование из полей записи в большой буфер через std::to_chars
+    Csv2        // csv2::Writer из подключенной библиотеки
+};
+
+inline void csv_append_int(std::string& out, long long value) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, res.ptr);
+}
+
+// Буферизованная запись строк CSV.
+// format(out, record) дописывает одну строку (с '\n') в out.
+// При threads > 1 записи обрабатываются порциями: каждая порция делится на
+// threads частей, части форматируются параллельно и пишутся в файл по порядку.
+template<typename Format>
+bool write_csv_buffered(const std::string& filename, const std::string& header,
+                        const std::vector<const flight*>& records, Format format, size_t threads = 1) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    const size_t FLUSH_BYTES = 4 * 1024 * 1024;
+
+    if (threads <= 1) {
+        std::string buffer;
+        buffer.reserve(FLUSH_BYTES + 1024);
+        for (const flight* f : records) {
+            format(buffer, *f);
+            if (buffer.size() >= FLUSH_BYTES) {
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        return static_cast<bool>(file);
+    }
+
+    // Порция ограничивает память: в буферах одновременно не больше ROUND_RECORDS строк
+    const size_t ROUND_RECORDS = 65536 * threads;
+    ThreadPool& pool = ThreadPool::shared();
+    std::vector<std::string> buffers(threads);
+
+    for (size_t round = 0; round < records.size(); round += ROUND_RECORDS) {
+        size_t round_end = std::min(records.size(), round + ROUND_RECORDS);
+        parallel_for_chunks(pool, round_end - round, threads, [&](size_t part, size_t begin, size_t end) {
+            std::string& buffer = buffers[part];
+            buffer.clear();
+            for (size_t i = round + begin; i < round + end; ++i) {
+                format(buffer, *records[i]);
+            }
+        });
+        for (auto& buffer : buffers) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+#endif //DATASETREADING_CSV_EXPORT_H
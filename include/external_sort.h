@@ -0,0 +1,45 @@
+#ifndef DATASETREADING_EXTERNAL_SORT_H
+#define DATASETREADING_EXTERNAL_SORT_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Внешняя сортировка CSV-файла, который не помещается в память.
+// 1. Строки читаются порциями не больше memory_limit байт, каждая порция
+//    сортируется по ключу и сбрасывается во временный файл (серию).
+// 2. Серии сливаются через дерево проигравших (k-путевое слияние); если серий
+//    больше max_merge_fan_in, сначала группами в промежуточные серии.
+// Сортировка устойчивая: при равных ключах строки идут в порядке входного файла.
+// Строки переносятся без изменений, заголовок (если есть) остается первой строкой.
+
+struct ExternalSortOptions {
+    size_t memory_limit = 256 * 1024 * 1024;   // байт строк в одной серии
+    std::string temp_dir;                      // пусто - рядом с выходным файлом
+    bool compress_runs = false;                // сжимать серии LZSS (меньше диска, дольше)
+    bool has_header = true;
+    size_t max_merge_fan_in = 256;             // сколько серий сливается за раз (открытых файлов)
+};
+
+struct ExternalSortStats {
+    bool success = false;
+    size_t records = 0;
+    size_t runs = 0;                // 0 - все поместилось в память, серии не создавались
+    uint64_t spilled_bytes = 0;     // сколько байт записано во временные файлы
+    size_t merge_passes = 0;        // проходов слияния, включая последний в выходной файл
+};
+
+// Ключ строки: беззнаковое число, строки упорядочиваются по возрастанию
+using ExternalSortKey = std::function<uint64_t(const std::string& line)>;
+
+ExternalSortStats external_sort_csv(const std::string& input_file, const std::string& output_file,
+                                    const ExternalSortKey& key_of,
+                                    const ExternalSortOptions& options = ExternalSortOptions());
+
+// Ключ по задержке прибытия (поле 21 строки с ';', пустое поле = 0, как при чтении)
+uint64_t csv_arr_delay_key(const std::string& line);
+
+ExternalSortStats external_sort_csv_by_arr_delay(const std::string& input_file, const std::string& output_file,
+                                                 const ExternalSortOptions& options = ExternalSortOptions());
+
+#endif //DATASETREADING_EXTERNAL_SORT_H
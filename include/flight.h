@@ -14,12 +14,27 @@ public:
     bool operator==(const flight& other) const;
     bool operator<(const flight& other) const;
     std::string get_unique_key() const;
+    // Дописывает ключ в конец out без промежуточных строк (формат как у get_unique_key)
+    void append_unique_key(std::string& out) const;
 
     const std::string& get_carrier_id() const { return carrier_id; }
     float get_flight_number() const { return flight_number; }
     const std::string& get_dest_state() const { return dest_state; }
     float get_arr_delay() const { return arr_delay; }
     bool is_canceled() const { return canceled; }
+    int get_year() const { return year; }
+    int get_month() const { return month; }
+    int get_month_day() const { return month_day; }
+    int get_week_day() const { return week_day; }
+    int get_crs_dep_time() const { return crs_dep_time; }
+    const std::string& get_origin_code() const { return origin_code; }
+    const std::string& get_dest_code() const { return dest_code; }
+    bool is_diverted() const { return diverted; }
+    char get_cancellation_code() const { return cancellation_code; }
+    bool hasCarrierDelay() const { return carrier_delay; }
+    bool hasNasDelay() const { return nas_delay; }
+    bool hasSecurityDelay() const { return security_delay; }
+    bool hasLateAircraftDelay() const { return late_aircraft_delay; }
 
     void setDistance(float d) { distance = d; }
     void setWeatherDelay(bool wd) { weather_delay = wd; }
@@ -29,6 +44,18 @@ public:
     std::string getOriginCity() const { return origin_city; }
     std::string getDestCity() const { return dest_city; }
 
+    // Обход всех строковых полей (для подсчета памяти)
+    template<typename Visitor>
+    void visit_strings(Visitor&& visit) const {
+        visit(carrier_id);
+        visit(origin_code);
+        visit(origin_city);
+        visit(origin_state);
+        visit(dest_code);
+        visit(dest_city);
+        visit(dest_state);
+    }
+
 private:
     int year{};
     int month{};
@@ -0,0 +1,40 @@
+#ifndef DATASETREADING_FLIGHT_CONTAINERS_H
+#define DATASETREADING_FLIGHT_CONTAINERS_H
+
+#include "flight.h"
+#include "memory_accounting.h"
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Контейнеры рейсов со счетчиком памяти
+using FlightVector = std::vector<flight, CountingAllocator<flight>>;
+using FlightUnorderedSet = std::unordered_set<flight, std::hash<flight>, std::equal_to<flight>,
+                                              CountingAllocator<flight>>;
+using FlightSet = std::set<flight, std::less<flight>, CountingAllocator<flight>>;
+using FlightUnorderedMap = std::unordered_map<std::string, flight, std::hash<std::string>, std::equal_to<std::string>,
+                                              CountingAllocator<std::pair<const std::string, flight>>>;
+using FlightMap = std::map<std::string, flight, std::less<std::string>,
+                           CountingAllocator<std::pair<const std::string, flight>>>;
+using FlightUnorderedMultimap = std::unordered_multimap<std::string, flight, std::hash<std::string>,
+                                                        std::equal_to<std::string>,
+                                                        CountingAllocator<std::pair<const std::string, flight>>>;
+using FlightMultimap = std::multimap<std::string, flight, std::less<std::string>,
+                                     CountingAllocator<std::pair<const std::string, flight>>>;
+
+// Память в куче, на которую ссылается запись (строковые поля вне буфера SSO)
+inline size_t heap_bytes(const flight& f) {
+    size_t bytes = 0;
+    f.visit_strings([&bytes](const std::string& s) { bytes += heap_bytes(s); });
+    return bytes;
+}
+
+// Полный размер одной записи
+inline size_t deep_size(const flight& f) {
+    return sizeof(flight) + heap_bytes(f);
+}
+
+#endif //DATASETREADING_FLIGHT_CONTAINERS_H
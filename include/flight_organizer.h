@@ -2,6 +2,11 @@
 #define DATASETREADING_FLIGHT_ORGANIZER_H
 
 #include "flight.h"
+#include "flight_containers.h"
+#include "flight_time_index.h"
+#include "bitmap_index.h"
+#include "bloom_filter.h"
+#include "csv_export.h"
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -9,16 +14,70 @@
 #include <set>
 #include <map>
 
+// Память, занятая одним контейнером FlightOrganizer
+struct ContainerMemory {
+    std::string name;
+    size_t records;
+    size_t bytes;
+};
+
+// Контейнеры, которые заполняет add_flight_to_all
+enum class FlightStorage {
+    Vector,
+    UnorderedSet,
+    Set,
+    UnorderedMap,
+    Map,
+    UnorderedMultimap,
+    Multimap
+};
+
 class FlightOrganizer {
 public:
     bool add_flight(const flight& f);
-    const std::unordered_set<flight>& get_all_unique_flights() const;
+    const FlightUnorderedSet& get_all_unique_flights() const;
     std::vector<flight> get_flights_by_aircraft(const std::string& carrier_id, float flight_number) const;
     std::vector<flight> get_flights_by_carrier(const std::string& carrier_id) const;
     size_t get_unique_flights_count() const;
-    void save_to_csv(const std::string& filename) const;
+    // threads > 1 используется только в режиме Buffered
+    void save_to_csv(const std::string& filename, CsvWriteMode mode = CsvWriteMode::Buffered, size_t threads = 1) const;
     void organize_by_aircraft();
 
+    // Индекс по времени вылета для каждого аэропорта; строится по unique_flights,
+    // после построения add_flight дописывает в него новые рейсы
+    void organize_by_time();
+    std::vector<const flight*> get_flights_by_time_range(const std::string& origin,
+                                                         const FlightDateTime& from,
+                                                         const FlightDateTime& to) const;
+
+    // Битовые индексы по флагам, коду отмены, дню недели и месяцу; строятся по unique_flights,
+    // add_flight их не обновляет
+    void organize_bitmaps();
+    const FlightBitmapIndex& get_bitmap_index() const { return bitmap_index; }
+
+    // Фильтр Блума по уникальным ключам всех записей организатора (unique_flights и
+    // контейнеры add_flight_to_all). После построения пополняется при добавлении; когда
+    // ключей становится больше, чем рассчитан фильтр, он перестраивается с той же долей
+    // ложных срабатываний и запасом в 2 раза. Поиск отсутствующего ключа через
+    // find_stored отсекается без обхода
+    void organize_key_filter(double false_positive_rate = 0.01);
+    const BloomFilter& get_key_filter() const { return key_filter; }
+    // false - ключа точно нет; без фильтра всегда true.
+    // key_hash = flight_key_hash(key): с готовым хешем проверка - одно обращение к блоку фильтра
+    bool may_contain_key(const std::string& key) const;
+    bool may_contain_key(uint64_t key_hash) const {
+        return key_filter.empty() || key_filter.might_contain(key_hash);
+    }
+    // Есть ли такой рейс среди unique_flights (проверка дубликата)
+    bool contains(const flight& f) const;
+    bool contains(const flight& f, uint64_t key_hash) const;
+
+    // Поиск по ключу в собственном контейнере с отсечением фильтром.
+    // Для мультиотображений find_stored возвращает первую запись, find_all_stored - все
+    const flight* find_stored(FlightStorage storage, const std::string& key, uint64_t key_hash) const;
+    std::vector<const flight*> find_all_stored(FlightStorage storage, const std::string& key,
+                                               uint64_t key_hash) const;
+
     void clear_all_structures();
     void add_flight_to_all(const flight& f);
 
@@ -31,71 +90,83 @@ public:
     template<typename MapContainer>
     std::vector<const flight*> find_in_multimap_container(const MapContainer& container, const std::string& key) const;
 
-    const std::vector<flight>& get_vector_flights() const { return vector_flights; }
-    const std::unordered_set<flight>& get_unordered_set_flights() const { return unordered_set_flights; }
-    const std::set<flight>& get_set_flights() const { return set_flights; }
-    const std::unordered_map<std::string, flight>& get_unordered_map_flights() const { return unordered_map_flights; }
-    const std::map<std::string, flight>& get_map_flights() const { return map_flights; }
-    const std::unordered_multimap<std::string, flight>& get_unordered_multimap_flights() const { return unordered_multimap_flights; }
-    const std::multimap<std::string, flight>& get_multimap_flights() const { return multimap_flights; }
+    const FlightVector& get_vector_flights() const { return vector_flights; }
+    const FlightUnorderedSet& get_unordered_set_flights() const { return unordered_set_flights; }
+    const FlightSet& get_set_flights() const { return set_flights; }
+    const FlightUnorderedMap& get_unordered_map_flights() const { return unordered_map_flights; }
+    const FlightMap& get_map_flights() const { return map_flights; }
+    const FlightUnorderedMultimap& get_unordered_multimap_flights() const { return unordered_multimap_flights; }
+    const FlightMultimap& get_multimap_flights() const { return multimap_flights; }
+
+    // Фактический объем памяти по каждому контейнеру (узлы, бакеты и строки записей)
+    // и по индексам поверх unique_flights. records индекса - число записей, на которые он ссылается
+    std::vector<ContainerMemory> get_memory_usage() const;
 
 private:
-    std::unordered_set<flight> unique_flights;
-    std::unordered_map<std::string, std::vector<flight*>> aircraft_to_flights;
+    FlightUnorderedSet unique_flights;
+    std::unordered_map<std::string, std::vector<flight*>, std::hash<std::string>, std::equal_to<std::string>,
+                       CountingAllocator<std::pair<const std::string, std::vector<flight*>>>> aircraft_to_flights;
     std::string get_aircraft_key(const flight& f) const;
+    FlightTimeIndex time_index;
+    FlightBitmapIndex bitmap_index;
+    BloomFilter key_filter;
+    size_t key_filter_capacity = 0;     // на сколько ключей рассчитан key_filter
+    double key_filter_rate = 0.01;
+    void build_key_filter(size_t capacity);
+    void add_key_hash(uint64_t key_hash);
 
-    std::vector<flight> vector_flights;
-    std::unordered_set<flight> unordered_set_flights;
-    std::set<flight> set_flights;
-    std::unordered_map<std::string, flight> unordered_map_flights;
-    std::map<std::string, flight> map_flights;
-    std::unordered_multimap<std::string, flight> unordered_multimap_flights;
-    std::multimap<std::string, flight> multimap_flights;
+    FlightVector vector_flights;
+    FlightUnorderedSet unordered_set_flights;
+    FlightSet set_flights;
+    FlightUnorderedMap unordered_map_flights;
+    FlightMap map_flights;
+    FlightUnorderedMultimap unordered_multimap_flights;
+    FlightMultimap multimap_flights;
 };
 
 template<typename Container>
 void FlightOrganizer::add_to_container(Container& container, const flight& f) {
-    if constexpr (std::is_same_v<Container, std::vector<flight>>) {
+    if constexpr (std::is_same_v<Container, FlightVector>) {
         container.push_back(f);
     }
-    else if constexpr (std::is_same_v<Container, std::unordered_set<flight>> ||
-        std::is_same_v<Container, std::set<flight>>) {
+    else if constexpr (std::is_same_v<Container, FlightUnorderedSet> ||
+        std::is_same_v<Container, FlightSet>) {
         container.insert(f);
     }
-    else if constexpr (std::is_same_v<Container, std::unordered_map<std::string, flight>> ||
-        std::is_same_v<Container, std::map<std::string, flight>>) {
+    else if constexpr (std::is_same_v<Container, FlightUnorderedMap> ||
+        std::is_same_v<Container, FlightMap>) {
         container[f.get_unique_key()] = f;
     }
-    else if constexpr (std::is_same_v<Container, std::unordered_multimap<std::string, flight>> ||
-        std::is_same_v<Container, std::multimap<std::string, flight>>) {
+    else if constexpr (std::is_same_v<Container, FlightUnorderedMultimap> ||
+        std::is_same_v<Container, FlightMultimap>) {
         container.insert({ f.get_unique_key(), f });
     }
 }
 
 template<typename Container>
 const flight* FlightOrganizer::find_in_container(const Container& container, const std::string& key) const {
-    if constexpr (std::is_same_v<Container, std::vector<flight>>) {
+    if constexpr (std::is_same_v<Container, FlightVector>) {
         for (const auto& f : container) {
             if (f.get_unique_key() == key) {
                 return &f;
             }
         }
     }
-    else if constexpr (std::is_same_v<Container, std::unordered_set<flight>> ||
-        std::is_same_v<Container, std::set<flight>>) {
+    else if constexpr (std::is_same_v<Container, FlightUnorderedSet> ||
+        std::is_same_v<Container, FlightSet>) {
         for (const auto& f : container) {
             if (f.get_unique_key() == key) {
                 return &f;
             }
         }
     }
-    else if constexpr (std::is_same_v<Container, std::unordered_map<std::string, flight>>) {
+    else if constexpr (std::is_same_v<Container, FlightUnorderedMap>) {
         auto it = container.find(key);
         if (it != container.end()) {
             return &it->second;
         }
     }
-    else if constexpr (std::is_same_v<Container, std::map<std::string, flight>>) {
+    else if constexpr (std::is_same_v<Container, FlightMap>) {
         auto it = container.find(key);
         if (it != container.end()) {
             return &it->second;
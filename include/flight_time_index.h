@@ -0,0 +1,68 @@
+#ifndef DATASETREADING_FLIGHT_TIME_INDEX_H
+#define DATASETREADING_FLIGHT_TIME_INDEX_H
+
+#include "flight.h"
+#include "flight_containers.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Момент вылета по расписанию: дата + время HHMM (как в crs_dep_time)
+struct FlightDateTime {
+    int year{};
+    int month{};
+    int day{};
+    int hhmm{};
+
+    // Упаковка в одно число YYYYMMDDHHMM, сохраняющая порядок
+    int64_t to_key() const;
+    static FlightDateTime of(const flight& f);
+};
+
+// Индекс рейсов, упорядоченных по времени вылета, отдельно для каждого аэропорта вылета.
+// Хранит указатели на записи исходного контейнера, поэтому контейнер
+// не должен изменяться, пока индекс используется.
+class FlightTimeIndex {
+public:
+    void build(const FlightUnorderedSet& flights);
+    // Вставка одной записи. Запись попадает в небольшой отсортированный буфер аэропорта,
+    // который вливается в основную шкалу, когда становится длиннее ~sqrt(n): амортизированно
+    // O(sqrt n) на вставку вместо сдвига всей шкалы
+    void add(const flight& f);
+    void clear();
+
+    // Рейсы из origin с вылетом в [from, to] (границы включительно), по возрастанию времени.
+    // Поиск границ - бинарный в шкале и в буфере, результат - их слияние, O(log n + k)
+    std::vector<const flight*> query(const std::string& origin,
+                                     const FlightDateTime& from, const FlightDateTime& to) const;
+
+    // Количество рейсов в диапазоне без построения результата, O(log n)
+    size_t count(const std::string& origin, const FlightDateTime& from, const FlightDateTime& to) const;
+
+    size_t get_origin_count() const { return by_origin.size(); }
+    // Число проиндексированных рейсов
+    size_t size() const;
+    bool empty() const { return by_origin.empty(); }
+    // Узлы и бакеты словаря, строки аэропортов и массивы шкал
+    size_t memory_bytes() const;
+
+private:
+    // Ключи и указатели хранятся раздельно, чтобы бинарный поиск шел по плотному массиву.
+    // pending_* - записи, добавленные после построения, в том же порядке, что и основная шкала
+    struct Timeline {
+        std::vector<int64_t> keys;
+        std::vector<const flight*> flights;
+        std::vector<int64_t> pending_keys;
+        std::vector<const flight*> pending_flights;
+    };
+
+    const Timeline* find_timeline(const std::string& origin) const;
+    static void merge_pending(Timeline& timeline);
+
+    std::unordered_map<std::string, Timeline, std::hash<std::string>, std::equal_to<std::string>,
+                       CountingAllocator<std::pair<const std::string, Timeline>>> by_origin;
+};
+
+#endif //DATASETREADING_FLIGHT_TIME_INDEX_H
@@ -0,0 +1,87 @@
+#ifndef DATASETREADING_MEMORY_ACCOUNTING_H
+#define DATASETREADING_MEMORY_ACCOUNTING_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+// Счетчик памяти, выделенной контейнером через CountingAllocator
+struct MemoryCounter {
+    size_t bytes = 0;          // занято сейчас
+    size_t peak_bytes = 0;     // максимум за время жизни
+    size_t allocations = 0;    // число вызовов allocate
+};
+
+// Аллокатор, который считает байты узлов, массивов бакетов и буферов контейнера.
+// Все копии (в том числе rebind на тип узла) пишут в один счетчик.
+template<typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    CountingAllocator() : counter(std::make_shared<MemoryCounter>()) {}
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : counter(other.get_counter()) {}
+
+    T* allocate(size_t n) {
+        size_t size = n * sizeof(T);
+        counter->bytes += size;
+        counter->allocations++;
+        if (counter->bytes > counter->peak_bytes) counter->peak_bytes = counter->bytes;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        counter->bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    // Копия контейнера получает собственный счетчик
+    CountingAllocator select_on_container_copy_construction() const { return CountingAllocator(); }
+
+    const std::shared_ptr<MemoryCounter>& get_counter() const { return counter; }
+    size_t allocated_bytes() const { return counter->bytes; }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>& other) const { return counter == other.get_counter(); }
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>& other) const { return counter != other.get_counter(); }
+
+private:
+    std::shared_ptr<MemoryCounter> counter;
+};
+
+// Байты в куче, принадлежащие строке (0, если строка помещается в буфер SSO)
+inline size_t heap_bytes(const std::string& s) {
+    const char* data = s.data();
+    const char* object = reinterpret_cast<const char*>(&s);
+    std::less<const char*> before;
+    if (!before(data, object) && before(data, object + sizeof(std::string))) {
+        return 0;
+    }
+    return s.capacity() + 1;
+}
+
+template<typename A, typename B>
+size_t heap_bytes(const std::pair<A, B>& p) {
+    return heap_bytes(p.first) + heap_bytes(p.second);
+}
+
+// Полный размер контейнера: сам объект, все его выделения и память в куче,
+// на которую ссылаются элементы (строки внутри flight и ключи словарей)
+template<typename Container>
+size_t container_bytes(const Container& container) {
+    size_t bytes = sizeof(Container) + container.get_allocator().allocated_bytes();
+    for (const auto& item : container) {
+        bytes += heap_bytes(item);
+    }
+    return bytes;
+}
+
+#endif //DATASETREADING_MEMORY_ACCOUNTING_H
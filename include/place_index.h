@@ -0,0 +1,111 @@
+#ifndef DATASETREADING_PLACE_INDEX_H
+#define DATASETREADING_PLACE_INDEX_H
+
+#include "flight.h"
+#include "flight_containers.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class PlaceKind : uint8_t {
+    City,       // origin_city / dest_city
+    Airport     // origin_code / dest_code
+};
+
+// Рейсы, связанные с местом (указатели в исходный контейнер)
+struct PlaceFlights {
+    const flight* const* first = nullptr;
+    const flight* const* last = nullptr;
+
+    const flight* const* begin() const { return first; }
+    const flight* const* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+struct PlaceMatch {
+    uint32_t id;
+    unsigned distance;  // расстояние Левенштейна от запроса (для find_fuzzy_prefix - до ближайшего префикса имени)
+};
+
+// Префиксное дерево названий городов и кодов аэропортов для автодополнения.
+// Имена сравниваются без учета регистра (ASCII), '_' равно пробелу: "new_york" найдет "New York, NY".
+// Места нумеруются в лексикографическом порядке нормализованных имен, поэтому все места
+// под узлом дерева образуют непрерывный диапазон номеров, и поиск по префиксу - это спуск
+// на длину префикса без обхода поддерева. Дерево хранится плоскими массивами
+// (узлы, затем дуги каждого узла подряд, отсортированные по символу).
+// Хранит указатели на записи исходного контейнера, поэтому контейнер
+// не должен изменяться, пока индекс используется.
+class PlaceNameIndex {
+public:
+    static const uint32_t NOT_FOUND = UINT32_MAX;
+
+    void build(const std::vector<flight>& flights);
+    void build(const FlightUnorderedSet& flights);
+    void clear();
+
+    // Точное совпадение имени (после нормализации)
+    uint32_t find(const std::string& name, PlaceKind kind) const;
+
+    // Места, имя которых начинается с prefix, в лексикографическом порядке, не больше limit.
+    // O(|prefix| + результат)
+    std::vector<uint32_t> find_prefix(const std::string& prefix, size_t limit = SIZE_MAX) const;
+
+    // Места на расстоянии Левенштейна не больше max_distance от name: обход дерева
+    // с одной строкой таблицы расстояний на уровень, ветви, где минимум строки уже больше
+    // max_distance, отсекаются. Результат по возрастанию расстояния, затем имени
+    std::vector<PlaceMatch> find_fuzzy(const std::string& name, unsigned max_distance,
+                                       size_t limit = SIZE_MAX) const;
+
+    // Автодополнение с опечатками: расстояние считается до ближайшего префикса имени
+    // ("Chicgo" -> "Chicago, IL" с расстоянием 1). Поддерево, к которому уже подошел
+    // префикс, дальше не обходится: его места добавляются одним диапазоном
+    std::vector<PlaceMatch> find_fuzzy_prefix(const std::string& prefix, unsigned max_distance,
+                                              size_t limit = SIZE_MAX) const;
+
+    const std::string& get_name(uint32_t id) const { return places[id].name; }
+    PlaceKind get_kind(uint32_t id) const { return places[id].kind; }
+    PlaceFlights get_flights(uint32_t id) const;
+
+    size_t size() const { return places.size(); }
+    size_t get_node_count() const { return nodes.size(); }
+    size_t memory_bytes() const;
+
+    static std::string normalize(const std::string& name);
+
+private:
+    struct Place {
+        std::string name;       // как в данных
+        PlaceKind kind;
+        uint32_t flights_begin; // диапазон в flight_refs
+        uint32_t flights_end;
+    };
+
+    // Места поддерева - [place_begin, place_end), из них заканчиваются в этом узле
+    // [place_begin, terminal_end); дуги - [edge_begin, edge_begin + edge_count)
+    struct Node {
+        uint32_t edge_begin;
+        uint32_t edge_count;
+        uint32_t place_begin;
+        uint32_t terminal_end;
+        uint32_t place_end;
+    };
+
+    template<typename Container>
+    void build_from(const Container& flights);
+    uint32_t add_node(const std::vector<std::string>& keys, uint32_t begin, uint32_t end, size_t depth);
+    uint32_t descend(const std::string& normalized) const;
+    std::vector<PlaceMatch> fuzzy_search(const std::string& name, unsigned max_distance, size_t limit,
+                                         bool by_prefix) const;
+    // best - наименьшее расстояние до префиксов на пути к узлу (только при by_prefix)
+    void fuzzy_visit(uint32_t node, const std::string& query, std::vector<unsigned>& rows, size_t depth,
+                     unsigned max_distance, bool by_prefix, unsigned best, std::vector<PlaceMatch>& out) const;
+
+    std::vector<Place> places;
+    std::vector<const flight*> flight_refs;
+    std::vector<Node> nodes;
+    std::vector<uint8_t> edge_labels;
+    std::vector<uint32_t> edge_targets;
+};
+
+#endif //DATASETREADING_PLACE_INDEX_H
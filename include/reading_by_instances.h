@@ -5,6 +5,7 @@
 #include <vector>
 #include <unordered_set>
 #include "flight.h"
+#include "csv_export.h"
 
 // Вспомогательные функции парсинга
 std::string parse_line(const std::string& line);
@@ -20,6 +21,7 @@ std::unordered_set<flight> read_flights_by_library(const std::string& filename,
 size_t get_file_size(const std::string& filename);
 
 // Функция сохранения
-void save_unique_keys_to_csv(const std::unordered_set<flight>& flights, const std::string& filename);
+void save_unique_keys_to_csv(const std::unordered_set<flight>& flights, const std::string& filename,
+                             CsvWriteMode mode = CsvWriteMode::Buffered, size_t threads = 1);
 
 #endif // READING_BY_INSTANCES_H
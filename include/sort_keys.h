@@ -0,0 +1,259 @@
+#ifndef DATASETREADING_SORT_KEYS_H
+#define DATASETREADING_SORT_KEYS_H
+
+#include "flight.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Порядок сортировки, задаваемый на этапе компиляции из геттеров flight:
+//
+//   using SpecialFlightOrder = order_by<by<&flight::is_canceled, desc>,
+//                                       by<&flight::get_dest_state>,
+//                                       by<&flight::get_arr_delay, desc>>;
+//
+// order_by дает компаратор (числовые поля сравниваются без ветвлений) и,
+// через PackedKey, упаковку всех полей в один 64-битный ключ для поразрядной сортировки.
+
+struct asc {};
+struct desc {};
+
+// Отображение float -> uint32, при котором порядок беззнаковых чисел совпадает с порядком float
+// (-0.0 и +0.0 дают один ключ)
+inline uint32_t orderedFloatKey(float value) {
+    value += 0.0f;
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+namespace sort_keys_detail {
+    // Ширина и кодирование с сохранением порядка для числовых типов.
+    // Строки кодируются номером в словаре, их ширина известна только по данным (bits = 0)
+    template<typename T, typename = void>
+    struct key_code;
+
+    template<>
+    struct key_code<bool> {
+        static constexpr unsigned bits = 1;
+        static uint64_t encode(bool v) { return v ? 1 : 0; }
+    };
+
+    template<>
+    struct key_code<char> {
+        static constexpr unsigned bits = 8;
+        static uint64_t encode(char v) { return static_cast<unsigned char>(v); }
+    };
+
+    template<>
+    struct key_code<int> {
+        static constexpr unsigned bits = 32;
+        static uint64_t encode(int v) { return static_cast<uint32_t>(v) ^ 0x80000000u; }
+    };
+
+    template<>
+    struct key_code<float> {
+        static constexpr unsigned bits = 32;
+        static uint64_t encode(float v) { return orderedFloatKey(v); }
+    };
+
+    template<>
+    struct key_code<std::string> {
+        static constexpr unsigned bits = 0;
+    };
+
+    // Первые 8 байт строки (big-endian, недостающие - нули): порядок чисел
+    // совпадает с лексикографическим порядком префиксов
+    inline uint64_t string_prefix(const std::string& s) {
+        uint64_t code = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            code = (code << 8) | (i < s.size() ? static_cast<unsigned char>(s[i]) : 0u);
+        }
+        return code;
+    }
+
+    inline unsigned bits_for(size_t distinct) {
+        unsigned bits = 0;
+        while (bits < 64 && (uint64_t{1} << bits) < distinct) bits++;
+        return bits;
+    }
+}
+
+template<auto Getter, typename Direction = asc>
+struct by {
+    using value_type = std::decay_t<std::invoke_result_t<decltype(Getter), const flight&>>;
+    static constexpr bool descending = std::is_same_v<Direction, desc>;
+    static constexpr bool is_string = std::is_same_v<value_type, std::string>;
+    static constexpr unsigned bits = sort_keys_detail::key_code<value_type>::bits;
+
+    static decltype(auto) get(const flight& f) { return (f.*Getter)(); }
+
+    // Трехзначное сравнение: < 0, 0, > 0 с учетом направления
+    static int compare(const flight& a, const flight& b) {
+        int c;
+        if constexpr (is_string) {
+            int raw = get(a).compare(get(b));
+            c = (raw > 0) - (raw < 0);
+        }
+        else {
+            auto x = get(a);
+            auto y = get(b);
+            c = (x > y) - (x < y);
+        }
+        return descending ? -c : c;
+    }
+
+    // Код поля без словаря (для decorate-sort-undecorate): числа кодируются полностью,
+    // строки - 8-байтовым префиксом; убывающие поля инвертируются
+    static uint64_t prefix_code(const flight& f) {
+        uint64_t code;
+        uint64_t mask;
+        if constexpr (is_string) {
+            code = sort_keys_detail::string_prefix(get(f));
+            mask = ~uint64_t{0};
+        }
+        else {
+            code = sort_keys_detail::key_code<value_type>::encode(get(f));
+            mask = bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+        }
+        return descending ? mask ^ code : code;
+    }
+
+    // Префикс не определяет строку полностью: при равных префиксах нужно сравнить записи
+    static bool prefix_truncated(const flight& f) {
+        if constexpr (is_string) {
+            return get(f).size() > 8;
+        }
+        else {
+            return false;
+        }
+    }
+};
+
+template<typename... Keys>
+struct order_by {
+    static_assert(sizeof...(Keys) > 0, "order_by needs at least one key");
+
+    static constexpr bool has_strings = (Keys::is_string || ...);
+    static constexpr size_t key_count = sizeof...(Keys);
+
+    // Коды полей (см. by::prefix_code) и маска полей с усеченными строками
+    static void prefix_codes(const flight& f, uint64_t* codes, uint32_t& truncated) {
+        size_t i = 0;
+        truncated = 0;
+        ((codes[i] = Keys::prefix_code(f), truncated |= Keys::prefix_truncated(f) ? (1u << i) : 0u, ++i), ...);
+    }
+
+    // Следующий ключ сравнивается, только если все предыдущие равны
+    static int compare(const flight& a, const flight& b) {
+        int c = 0;
+        (void)(((c = Keys::compare(a, b)) != 0) || ...);
+        return c;
+    }
+
+    bool operator()(const flight& a, const flight& b) const {
+        return compare(a, b) < 0;
+    }
+};
+
+// Упаковка полей порядка в один uint64: первое поле - в старших битах,
+// убывающие поля инвертируются. Для строковых полей по данным строится словарь
+// (номер = ранг строки), поэтому объект создается для конкретного набора записей.
+template<typename Order>
+class PackedKey;
+
+template<typename... Keys>
+class PackedKey<order_by<Keys...>> {
+public:
+    explicit PackedKey(const std::vector<flight>& flights) {
+        build(flights, std::index_sequence_for<Keys...>());
+    }
+
+    // Помещаются ли все поля в 64 бита; если нет, упакованный ключ использовать нельзя
+    bool fits() const { return total_bits <= 64; }
+    unsigned get_total_bits() const { return total_bits; }
+
+    uint64_t operator()(const flight& f) const {
+        return encode(f, std::index_sequence_for<Keys...>());
+    }
+
+private:
+    using KeyTuple = std::tuple<Keys...>;
+    static constexpr size_t KEY_COUNT = sizeof...(Keys);
+
+    template<size_t... I>
+    void build(const std::vector<flight>& flights, std::index_sequence<I...>) {
+        total_bits = 0;
+        (build_key<I>(flights), ...);
+    }
+
+    template<size_t I>
+    void build_key(const std::vector<flight>& flights) {
+        using Key = std::tuple_element_t<I, KeyTuple>;
+        if constexpr (Key::is_string) {
+            auto& dictionary = dictionaries[I];
+            for (const auto& f : flights) {
+                dictionary.emplace(Key::get(f), 0);
+            }
+            std::vector<const std::string*> sorted;
+            sorted.reserve(dictionary.size());
+            for (const auto& entry : dictionary) {
+                sorted.push_back(&entry.first);
+            }
+            std::sort(sorted.begin(), sorted.end(),
+                      [](const std::string* a, const std::string* b) { return *a < *b; });
+            for (uint32_t rank = 0; rank < sorted.size(); ++rank) {
+                dictionary[*sorted[rank]] = rank;
+            }
+            widths[I] = sort_keys_detail::bits_for(sorted.size());
+        }
+        else {
+            widths[I] = Key::bits;
+        }
+        total_bits += widths[I];
+    }
+
+    template<size_t I>
+    uint64_t field(const flight& f) const {
+        using Key = std::tuple_element_t<I, KeyTuple>;
+        uint64_t code;
+        if constexpr (Key::is_string) {
+            auto it = dictionaries[I].find(Key::get(f));
+            code = it == dictionaries[I].end() ? 0 : it->second;
+        }
+        else {
+            code = sort_keys_detail::key_code<typename Key::value_type>::encode(Key::get(f));
+        }
+        if constexpr (Key::descending) {
+            uint64_t mask = widths[I] >= 64 ? ~uint64_t{0} : (uint64_t{1} << widths[I]) - 1;
+            code = mask ^ code;
+        }
+        return code;
+    }
+
+    template<size_t... I>
+    uint64_t encode(const flight& f, std::index_sequence<I...>) const {
+        uint64_t key = 0;
+        ((key = (widths[I] >= 64 ? 0 : key << widths[I]) | field<I>(f)), ...);
+        return key;
+    }
+
+    std::array<unsigned, KEY_COUNT> widths{};
+    std::array<std::unordered_map<std::string, uint32_t>, KEY_COUNT> dictionaries;
+    unsigned total_bits = 0;
+};
+
+// Порядки, используемые в проекте
+using ArrivalDelayOrder = order_by<by<&flight::get_arr_delay>>;
+using SpecialFlightOrder = order_by<by<&flight::is_canceled, desc>,
+                                    by<&flight::get_dest_state>,
+                                    by<&flight::get_arr_delay, desc>>;
+
+#endif //DATASETREADING_SORT_KEYS_H
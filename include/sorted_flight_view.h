@@ -0,0 +1,142 @@
+#ifndef DATASETREADING_SORTED_FLIGHT_VIEW_H
+#define DATASETREADING_SORTED_FLIGHT_VIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "flight.h"
+#include "sort_keys.h"
+#include "sorting.h"
+
+// Записи, поддерживаемые упорядоченными по Order (см. sort_keys.h) при добавлении:
+//
+//   SortedFlightView<SpecialFlightOrder> view;
+//   view.insert(batch.begin(), batch.end());
+//   const auto& ordered = view.sorted();
+//
+// Устроено как LSM: новые записи копятся в хвосте, при заполнении пакета хвост
+// сортируется в отдельную серию, а серии сливаются с соседними, когда новая
+// не меньше половины предыдущей (каждая запись переслияется O(log n) раз).
+// sorted() сливает оставшиеся серии в одну, поэтому полная пересортировка
+// не нужна никогда. Порядок устойчивый: при равных ключах раньше добавленная запись идет раньше.
+template<typename Order>
+class SortedFlightView {
+public:
+    explicit SortedFlightView(size_t batch_size = 4096) : batch_size(std::max<size_t>(1, batch_size)) {}
+
+    void insert(const flight& f) {
+        data.push_back(f);
+        if (pending_count() >= batch_size) flush();
+    }
+
+    void insert(flight&& f) {
+        data.push_back(std::move(f));
+        if (pending_count() >= batch_size) flush();
+    }
+
+    template<typename Iterator>
+    void insert(Iterator first, Iterator last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    // Сортирует накопленный хвост в новую серию
+    void flush() {
+        size_t start = sorted_count();
+        size_t n = data.size() - start;
+        if (n == 0) return;
+
+        buffer.resize(std::max(buffer.size(), n));
+        flight* result = sorting_detail::mergeSortRange<Order>(data.data() + start, buffer.data(), n);
+        if (result != data.data() + start) {
+            std::move(result, result + n, data.data() + start);
+        }
+        run_ends.push_back(data.size());
+
+        while (run_ends.size() >= 2 && 2 * run_size(run_ends.size() - 1) >= run_size(run_ends.size() - 2)) {
+            merge_last_runs();
+        }
+    }
+
+    // Сливает все серии в одну
+    void compact() {
+        flush();
+        while (run_ends.size() >= 2) {
+            merge_last_runs();
+        }
+    }
+
+    // Все записи в порядке Order
+    const std::vector<flight>& sorted() {
+        compact();
+        return data;
+    }
+
+    size_t size() const { return data.size(); }
+    bool empty() const { return data.empty(); }
+    size_t get_run_count() const { return run_ends.size(); }
+    size_t get_pending_count() const { return pending_count(); }
+    // Сколько перемещений записей выполнено слияниями (мера работы поддержки порядка)
+    size_t get_merged_records() const { return merged_records; }
+
+    void clear() {
+        data.clear();
+        run_ends.clear();
+        buffer.clear();
+        merged_records = 0;
+    }
+
+private:
+    size_t sorted_count() const { return run_ends.empty() ? 0 : run_ends.back(); }
+    size_t pending_count() const { return data.size() - sorted_count(); }
+
+    size_t run_size(size_t run) const {
+        return run_ends[run] - (run == 0 ? 0 : run_ends[run - 1]);
+    }
+
+    // Слияние двух последних серий с конца: в буфер переносится только правая (более новая)
+    // серия, а из левой перемещаются лишь записи, большие наименьшей записи правой
+    void merge_last_runs() {
+        size_t right_end = run_ends.back();
+        run_ends.pop_back();
+        size_t mid = run_ends.back();
+        size_t left_start = run_ends.size() >= 2 ? run_ends[run_ends.size() - 2] : 0;
+        run_ends.back() = right_end;
+
+        flight* left_first = data.data() + left_start;
+        flight* left = data.data() + mid;
+        size_t right_n = right_end - mid;
+        // Правая серия уже на месте, если она не меньше последней записи левой
+        if (left == left_first || right_n == 0 || !(Order::compare(*left, *(left - 1)) < 0)) {
+            return;
+        }
+
+        buffer.resize(std::max(buffer.size(), right_n));
+        std::move(left, left + right_n, buffer.data());
+        flight* right_first = buffer.data();
+        flight* right = buffer.data() + right_n;
+        flight* out = data.data() + right_end;
+
+        while (right > right_first && left > left_first) {
+            // При равенстве позже идет запись из правой серии
+            if (Order::compare(*(right - 1), *(left - 1)) < 0) {
+                *--out = std::move(*--left);
+            }
+            else {
+                *--out = std::move(*--right);
+            }
+        }
+        std::move_backward(right_first, right, out);
+        merged_records += static_cast<size_t>((data.data() + right_end) - left);
+    }
+
+    size_t batch_size;
+    std::vector<flight> data;       // серии подряд, затем несортированный хвост
+    std::vector<size_t> run_ends;   // конец каждой серии в data
+    std::vector<flight> buffer;
+    size_t merged_records = 0;
+};
+
+#endif //DATASETREADING_SORTED_FLIGHT_VIEW_H
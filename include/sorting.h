@@ -1,10 +1,432 @@
 #ifndef DATASETREADING_SORTING_H
 #define DATASETREADING_SORTING_H
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <type_traits>
 #include <vector>
 #include "flight.h"
+#include "sort_keys.h"
+#include "thread_pool.h"
 
 void mergeSortByArrivalDelay(std::vector<flight>& flights);
 void specialFlightSort(std::vector<flight>& flights);
 
-#endif
\ No newline at end of file
+// Параллельная устойчивая сортировка слиянием по задержке прибытия:
+// куски сортируются в пуле потоков, затем сливаются попарно, причем каждое слияние
+// делится между потоками по рангам выхода. threads = 0 - размер общего пула
+void parallelMergeSortByArrivalDelay(std::vector<flight>& flights, size_t threads = 0);
+
+// Сортировка перестановкой: ключи извлекаются в плотный массив, сортируются вместе
+// с 4-байтовыми индексами, а сами записи не перемещаются.
+// Результат: perm[i] - индекс записи, стоящей на i-м месте
+std::vector<uint32_t> sortPermutationByArrivalDelay(const std::vector<flight>& flights);
+std::vector<uint32_t> specialFlightSortPermutation(const std::vector<flight>& flights);
+
+// Поразрядная (LSD) сортировка за O(n), устойчивая.
+// По задержке: float отображается в uint32 с сохранением порядка.
+// Специальный порядок: (отмена, штат назначения, задержка по убыванию) упаковываются
+// в один 64-битный ключ: бит отмены, номер штата в словаре, инвертированная задержка
+std::vector<uint32_t> radixSortPermutationByArrivalDelay(const std::vector<flight>& flights);
+std::vector<uint32_t> radixSpecialFlightSortPermutation(const std::vector<flight>& flights);
+void radixSortByArrivalDelay(std::vector<flight>& flights);
+void radixSpecialFlightSort(std::vector<flight>& flights);
+
+// Decorate-sort-undecorate для специального порядка: ключи (отмена, префикс штата,
+// задержка) извлекаются один раз, сравниваются массивы чисел, а не геттеры и строки
+std::vector<uint32_t> decoratedSpecialFlightSortPermutation(const std::vector<flight>& flights);
+void decoratedSpecialFlightSort(std::vector<flight>& flights);
+
+// Переставляет элементы на месте так, что items[i] = старый items[perm[i]].
+// Каждый элемент перемещается один раз (обход циклов перестановки)
+template<typename T>
+void apply_permutation(std::vector<T>& items, const std::vector<uint32_t>& perm) {
+    std::vector<bool> placed(items.size(), false);
+    for (size_t start = 0; start < items.size(); ++start) {
+        if (placed[start] || perm[start] == start) continue;
+        T tmp = std::move(items[start]);
+        size_t j = start;
+        while (true) {
+            placed[j] = true;
+            size_t k = perm[j];
+            if (k == start) break;
+            items[j] = std::move(items[k]);
+            j = k;
+        }
+        items[j] = std::move(tmp);
+    }
+}
+
+// ============================================
+// Обобщенные сортировки по порядку order_by<...> (см. sort_keys.h)
+// ============================================
+
+namespace sorting_detail {
+    // Короткие серии сортируются вставками, дальше - восходящая сортировка слиянием
+    const size_t INSERTION_SORT_RUN = 32;
+
+    // Порядок может объявить static void on_moves(size_t) и считать перемещения записей
+    // (используется в бенчмарке); для обычных порядков вызов исчезает при компиляции
+    template<typename Order, typename = void>
+    struct has_move_counter : std::false_type {};
+
+    template<typename Order>
+    struct has_move_counter<Order, std::void_t<decltype(Order::on_moves(size_t{}))>> : std::true_type {};
+
+    template<typename Order>
+    inline void countMoves(size_t moves) {
+        if constexpr (has_move_counter<Order>::value) {
+            Order::on_moves(moves);
+        }
+    }
+
+    template<typename Order>
+    void insertionSort(flight* first, flight* last) {
+        for (flight* i = first + 1; i < last; ++i) {
+            if (!(Order::compare(*i, *(i - 1)) < 0)) continue;
+            flight tmp = std::move(*i);
+            flight* j = i;
+            while (j > first && Order::compare(tmp, *(j - 1)) < 0) {
+                *j = std::move(*(j - 1));
+                --j;
+            }
+            *j = std::move(tmp);
+            countMoves<Order>(static_cast<size_t>(i - j) + 2);
+        }
+    }
+
+    // Сливает [a, a_end) и [b, b_end) в out; при равенстве первой идет запись из a
+    template<typename Order>
+    void mergeMove(flight* a, flight* a_end, flight* b, flight* b_end, flight* out) {
+        countMoves<Order>(static_cast<size_t>((a_end - a) + (b_end - b)));
+        while (a < a_end && b < b_end) {
+            if (Order::compare(*b, *a) < 0) {
+                *out++ = std::move(*b++);
+            }
+            else {
+                *out++ = std::move(*a++);
+            }
+        }
+        out = std::move(a, a_end, out);
+        std::move(b, b_end, out);
+    }
+
+    // Сортирует data[0, n), используя buffer[0, n) как рабочую память.
+    // Возвращает указатель на тот из двух массивов, где оказался результат
+    template<typename Order>
+    flight* mergeSortRange(flight* data, flight* buffer, size_t n) {
+        for (size_t left = 0; left < n; left += INSERTION_SORT_RUN) {
+            insertionSort<Order>(data + left, data + std::min(n, left + INSERTION_SORT_RUN));
+        }
+
+        // На каждом проходе данные перекладываются между data и buffer
+        flight* src = data;
+        flight* dst = buffer;
+        for (size_t width = INSERTION_SORT_RUN; width < n; width *= 2) {
+            for (size_t left = 0; left < n; left += 2 * width) {
+                size_t mid = std::min(n, left + width);
+                size_t right = std::min(n, left + 2 * width);
+                mergeMove<Order>(src + left, src + mid, src + mid, src + right, dst + left);
+            }
+            std::swap(src, dst);
+        }
+        return src;
+    }
+
+    // Сколько записей берется из a среди первых k записей устойчивого слияния a и b
+    template<typename Order>
+    size_t coRank(size_t k, const flight* a, size_t a_len, const flight* b, size_t b_len) {
+        size_t lo = k > b_len ? k - b_len : 0;
+        size_t hi = std::min(k, a_len);
+        while (lo < hi) {
+            size_t i = lo + (hi - lo) / 2;
+            size_t j = k - i;
+            // a[i] не больше b[j - 1] - значит a[i] должен попасть в первые k, i мало
+            if (j > 0 && !(Order::compare(b[j - 1], a[i]) < 0)) {
+                lo = i + 1;
+            }
+            else {
+                hi = i;
+            }
+        }
+        return lo;
+    }
+
+    // Выполняет задачи в пуле; первая - в вызывающем потоке
+    inline void runJobs(ThreadPool& pool, std::vector<std::function<void()>>& jobs) {
+        std::vector<std::future<void>> pending;
+        pending.reserve(jobs.size());
+        for (size_t i = 1; i < jobs.size(); ++i) {
+            pending.push_back(pool.submit(jobs[i]));
+        }
+        if (!jobs.empty()) jobs[0]();
+        for (auto& f : pending) {
+            f.get();
+        }
+    }
+
+    // LSD по байтам ключа; indices переставляются вместе с ключами.
+    // Проходы, в которых все ключи имеют одинаковый байт, пропускаются
+    template<typename Key>
+    void radixSortPairs(std::vector<Key>& keys, std::vector<uint32_t>& indices) {
+        const size_t DIGITS = sizeof(Key);
+        size_t n = keys.size();
+        if (n < 2) return;
+
+        // Гистограммы для всех разрядов за один проход
+        std::vector<size_t> counts(DIGITS * 256, 0);
+        for (Key k : keys) {
+            for (size_t d = 0; d < DIGITS; ++d) {
+                counts[d * 256 + ((k >> (8 * d)) & 0xFF)]++;
+            }
+        }
+
+        std::vector<Key> keys_tmp(n);
+        std::vector<uint32_t> indices_tmp(n);
+        for (size_t d = 0; d < DIGITS; ++d) {
+            size_t* count = &counts[d * 256];
+            if (count[(keys[0] >> (8 * d)) & 0xFF] == n) continue;
+
+            size_t offsets[256];
+            size_t sum = 0;
+            for (size_t b = 0; b < 256; ++b) {
+                offsets[b] = sum;
+                sum += count[b];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                size_t pos = offsets[(keys[i] >> (8 * d)) & 0xFF]++;
+                keys_tmp[pos] = keys[i];
+                indices_tmp[pos] = indices[i];
+            }
+            keys.swap(keys_tmp);
+            indices.swap(indices_tmp);
+        }
+    }
+
+    // Перестановка сравнением записей, когда ключ не помещается в 64 бита
+    template<typename Order>
+    std::vector<uint32_t> comparePermutation(const std::vector<flight>& flights) {
+        std::vector<uint32_t> perm(flights.size());
+        for (uint32_t i = 0; i < perm.size(); ++i) {
+            perm[i] = i;
+        }
+        std::stable_sort(perm.begin(), perm.end(), [&flights](uint32_t a, uint32_t b) {
+            return Order::compare(flights[a], flights[b]) < 0;
+        });
+        return perm;
+    }
+}
+
+// Устойчивая сортировка слиянием с одним буфером
+template<typename Order>
+void mergeSortBy(std::vector<flight>& flights) {
+    size_t n = flights.size();
+    if (n <= sorting_detail::INSERTION_SORT_RUN) {
+        sorting_detail::insertionSort<Order>(flights.data(), flights.data() + n);
+        return;
+    }
+
+    // Единственный буфер на всю сортировку
+    std::vector<flight> buffer(n);
+    if (sorting_detail::mergeSortRange<Order>(flights.data(), buffer.data(), n) != flights.data()) {
+        flights.swap(buffer);
+    }
+}
+
+template<typename Order>
+void parallelMergeSortBy(std::vector<flight>& flights, size_t threads = 0) {
+    using namespace sorting_detail;
+
+    ThreadPool& pool = ThreadPool::shared();
+    if (threads == 0) threads = pool.size();
+    size_t n = flights.size();
+
+    // На маленьких входах накладные расходы больше выигрыша
+    const size_t MIN_PER_THREAD = 16384;
+    if (threads <= 1 || n < 2 * MIN_PER_THREAD) {
+        mergeSortBy<Order>(flights);
+        return;
+    }
+    threads = std::min(threads, n / MIN_PER_THREAD);
+
+    std::vector<flight> buffer(n);
+    flight* data = flights.data();
+    flight* scratch = buffer.data();
+
+    // 1. Каждый поток сортирует свой кусок; результат возвращается в flights
+    std::vector<size_t> bounds(threads + 1);
+    for (size_t t = 0; t <= threads; ++t) {
+        bounds[t] = n * t / threads;
+    }
+    std::vector<std::function<void()>> jobs;
+    for (size_t t = 0; t < threads; ++t) {
+        jobs.emplace_back([=]() {
+            size_t len = bounds[t + 1] - bounds[t];
+            flight* result = mergeSortRange<Order>(data + bounds[t], scratch + bounds[t], len);
+            if (result != data + bounds[t]) {
+                std::move(result, result + len, data + bounds[t]);
+                countMoves<Order>(len);
+            }
+        });
+    }
+    runJobs(pool, jobs);
+
+    // 2. Попарное слияние кусков. Каждое слияние делится на части по позиции в выходе
+    //    (co-rank), так что все потоки заняты и на последних раундах
+    flight* src = data;
+    flight* dst = scratch;
+    while (bounds.size() > 2) {
+        jobs.clear();
+        std::vector<size_t> next_bounds;
+        for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            size_t left = bounds[r];
+            next_bounds.push_back(left);
+            if (r + 2 >= bounds.size()) {
+                // Непарный кусок просто переносится
+                size_t right = bounds[r + 1];
+                jobs.emplace_back([=]() {
+                    std::move(src + left, src + right, dst + left);
+                    countMoves<Order>(right - left);
+                });
+                continue;
+            }
+
+            size_t mid = bounds[r + 1];
+            size_t right = bounds[r + 2];
+            size_t total = right - left;
+            size_t parts = std::max<size_t>(1, (threads * total + n - 1) / n);
+            for (size_t p = 0; p < parts; ++p) {
+                size_t k_begin = total * p / parts;
+                size_t k_end = total * (p + 1) / parts;
+                jobs.emplace_back([=]() {
+                    const flight* a = src + left;
+                    const flight* b = src + mid;
+                    size_t a_len = mid - left;
+                    size_t b_len = right - mid;
+                    size_t i_begin = coRank<Order>(k_begin, a, a_len, b, b_len);
+                    size_t i_end = coRank<Order>(k_end, a, a_len, b, b_len);
+                    mergeMove<Order>(src + left + i_begin, src + left + i_end,
+                                     src + mid + (k_begin - i_begin), src + mid + (k_end - i_end),
+                                     dst + left + k_begin);
+                });
+            }
+        }
+        next_bounds.push_back(n);
+        runJobs(pool, jobs);
+        bounds.swap(next_bounds);
+        std::swap(src, dst);
+    }
+
+    if (src != flights.data()) {
+        flights.swap(buffer);
+    }
+}
+
+// Устойчивая перестановка сравнением: при возможности сравниваются упакованные
+// 64-битные ключи, иначе - сами записи
+template<typename Order>
+std::vector<uint32_t> sortPermutationBy(const std::vector<flight>& flights) {
+    PackedKey<Order> packed(flights);
+    if (!packed.fits()) {
+        return sorting_detail::comparePermutation<Order>(flights);
+    }
+
+    struct KeyIndex {
+        uint64_t key;
+        uint32_t index;
+    };
+    std::vector<KeyIndex> keys(flights.size());
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        keys[i] = { packed(flights[i]), i };
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const KeyIndex& a, const KeyIndex& b) {
+        return a.key < b.key;
+    });
+
+    std::vector<uint32_t> perm(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        perm[i] = keys[i].index;
+    }
+    return perm;
+}
+
+// Поразрядная сортировка по упакованному ключу; если ключ не помещается
+// в 64 бита, используется устойчивая сортировка сравнением
+template<typename Order>
+std::vector<uint32_t> radixSortPermutationBy(const std::vector<flight>& flights) {
+    PackedKey<Order> packed(flights);
+    if (!packed.fits()) {
+        return sorting_detail::comparePermutation<Order>(flights);
+    }
+
+    std::vector<uint32_t> perm(flights.size());
+    for (uint32_t i = 0; i < perm.size(); ++i) {
+        perm[i] = i;
+    }
+    if (packed.get_total_bits() <= 32) {
+        std::vector<uint32_t> keys(flights.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            keys[i] = static_cast<uint32_t>(packed(flights[i]));
+        }
+        sorting_detail::radixSortPairs(keys, perm);
+    }
+    else {
+        std::vector<uint64_t> keys(flights.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            keys[i] = packed(flights[i]);
+        }
+        sorting_detail::radixSortPairs(keys, perm);
+    }
+    return perm;
+}
+
+// Decorate-sort-undecorate: коды полей извлекаются один раз в плотный массив
+// (строки - 8-байтовыми префиксами, без словаря), сортируются массивы кодов
+// с индексами, и только при равных усеченных префиксах сравниваются сами записи.
+// Равные записи упорядочены по индексу, поэтому результат как у устойчивой сортировки
+template<typename Order>
+std::vector<uint32_t> decoratedSortPermutationBy(const std::vector<flight>& flights) {
+    constexpr size_t KEY_COUNT = Order::key_count;
+    struct Decorated {
+        std::array<uint64_t, KEY_COUNT> codes;
+        uint32_t truncated;
+        uint32_t index;
+    };
+
+    std::vector<Decorated> keys(flights.size());
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        Order::prefix_codes(flights[i], keys[i].codes.data(), keys[i].truncated);
+        keys[i].index = i;
+    }
+    std::sort(keys.begin(), keys.end(), [&flights](const Decorated& a, const Decorated& b) {
+        for (size_t i = 0; i < KEY_COUNT; ++i) {
+            if (a.codes[i] != b.codes[i]) {
+                return a.codes[i] < b.codes[i];
+            }
+            if (((a.truncated | b.truncated) >> i) & 1u) {
+                // Предыдущие поля равны, поэтому сравнение записей решает по этому и следующим полям
+                int c = Order::compare(flights[a.index], flights[b.index]);
+                if (c != 0) return c < 0;
+                break;
+            }
+        }
+        return a.index < b.index;
+    });
+
+    std::vector<uint32_t> perm(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        perm[i] = keys[i].index;
+    }
+    return perm;
+}
+
+// std::sort с компаратором порядка (неустойчивая)
+template<typename Order>
+void sortBy(std::vector<flight>& flights) {
+    std::sort(flights.begin(), flights.end(), Order());
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef DATASETREADING_THREAD_POOL_H
+#define DATASETREADING_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Простой пул потоков с общей очередью задач
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = default_thread_count());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template<typename F>
+    auto submit(F&& task) -> std::future<decltype(task())>;
+
+    size_t size() const { return workers.size(); }
+
+    // Общий пул процесса (создается при первом обращении)
+    static ThreadPool& shared();
+    static size_t default_thread_count();
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    bool stopping = false;
+};
+
+template<typename F>
+auto ThreadPool::submit(F&& task) -> std::future<decltype(task())> {
+    using Result = decltype(task());
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    queue_cv.notify_one();
+    return result;
+}
+
+// Делит [0, n) на parts непрерывных частей и выполняет body(part, begin, end) в пуле.
+// Часть 0 выполняется в вызывающем потоке. Нельзя вызывать из задачи того же пула
+template<typename Body>
+void parallel_for_chunks(ThreadPool& pool, size_t n, size_t parts, Body body) {
+    if (parts == 0) parts = 1;
+    if (parts > n) parts = n == 0 ? 1 : n;
+    size_t chunk = n / parts;
+    size_t extra = n % parts;
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(parts);
+    size_t begin = chunk + (extra > 0 ? 1 : 0);
+    for (size_t part = 1; part < parts; ++part) {
+        size_t end = begin + chunk + (part < extra ? 1 : 0);
+        pending.push_back(pool.submit([&body, part, begin, end]() { body(part, begin, end); }));
+        begin = end;
+    }
+    body(0, 0, chunk + (extra > 0 ? 1 : 0));
+    for (auto& f : pending) {
+        f.get();
+    }
+}
+
+#endif //DATASETREADING_THREAD_POOL_H
@@ -0,0 +1,77 @@
+#ifndef DATASETREADING_TOP_K_H
+#define DATASETREADING_TOP_K_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "flight.h"
+
+// Выбор K рейсов с наибольшей задержкой прибытия без полной сортировки.
+// Результат упорядочен по убыванию задержки; при равных задержках раньше идет
+// запись с меньшим индексом (как после устойчивой сортировки по убыванию).
+
+// Индексы K наибольших значений столбца.
+// Порог берется как K-е значение по равномерной выборке (он не больше K-го значения
+// всего столбца), кандидаты >= порога отбираются векторным сканированием
+// (см. column_scan.h), и только они проходят через nth_element. NaN не учитываются
+std::vector<size_t> top_k_indices(const std::vector<float>& values, size_t k);
+
+std::vector<const flight*> top_k_by_arr_delay(const std::vector<flight>& flights, size_t k);
+
+// K худших рейсов в каждой группе, например:
+//   top_k_by_arr_delay(flights, 100, &flight::get_dest_state)
+// group_by - геттер или любая функция от const flight&.
+// Для каждой группы поддерживается куча из K лучших кандидатов: O(n log K),
+// а при малом K почти все записи отсекаются одним сравнением с вершиной кучи
+template<typename GroupBy>
+auto top_k_by_arr_delay(const std::vector<flight>& flights, size_t k, GroupBy group_by)
+    -> std::map<std::decay_t<std::invoke_result_t<GroupBy, const flight&>>, std::vector<const flight*>> {
+    using Key = std::decay_t<std::invoke_result_t<GroupBy, const flight&>>;
+
+    // a раньше b в результате
+    auto better = [&flights](uint32_t a, uint32_t b) {
+        float x = flights[a].get_arr_delay();
+        float y = flights[b].get_arr_delay();
+        return x > y || (x == y && a < b);
+    };
+
+    // Вершина каждой кучи - худший из отобранных в группе
+    std::unordered_map<Key, std::vector<uint32_t>> heaps;
+    if (k > 0) {
+        for (size_t i = 0; i < flights.size(); ++i) {
+            const flight& f = flights[i];
+            float delay = f.get_arr_delay();
+            if (delay != delay) continue;
+
+            auto& heap = heaps[std::invoke(group_by, f)];
+            uint32_t index = static_cast<uint32_t>(i);
+            if (heap.size() < k) {
+                heap.push_back(index);
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+            else if (better(index, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), better);
+                heap.back() = index;
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+        }
+    }
+
+    std::map<Key, std::vector<const flight*>> result;
+    for (auto& entry : heaps) {
+        auto& heap = entry.second;
+        std::sort_heap(heap.begin(), heap.end(), better);
+        auto& top = result[entry.first];
+        top.reserve(heap.size());
+        for (uint32_t index : heap) {
+            top.push_back(&flights[index]);
+        }
+    }
+    return result;
+}
+
+#endif //DATASETREADING_TOP_K_H
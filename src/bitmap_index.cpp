@@ -0,0 +1,394 @@
+#include "bitmap_index.h"
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+// ============================================
+// RoaringBitmap: блоки
+// ============================================
+
+void RoaringBitmap::Container::to_words(vector<uint64_t>& out) const {
+    if (is_dense()) {
+        out = words;
+        return;
+    }
+    out.assign(WORDS, 0);
+    for (uint16_t v : array) {
+        out[v >> 6] |= uint64_t{1} << (v & 63);
+    }
+}
+
+void RoaringBitmap::Container::normalize() {
+    if (is_dense()) {
+        uint32_t count = 0;
+        for (uint64_t w : words) {
+            count += static_cast<uint32_t>(__builtin_popcountll(w));
+        }
+        cardinality = count;
+        if (cardinality <= ARRAY_LIMIT) {
+            array.clear();
+            array.reserve(cardinality);
+            for (size_t i = 0; i < WORDS; ++i) {
+                uint64_t w = words[i];
+                while (w != 0) {
+                    array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(w)));
+                    w &= w - 1;
+                }
+            }
+            words.clear();
+            words.shrink_to_fit();
+        }
+    }
+    else {
+        cardinality = static_cast<uint32_t>(array.size());
+        if (cardinality > ARRAY_LIMIT) {
+            to_words(words);
+            array.clear();
+            array.shrink_to_fit();
+        }
+    }
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+
+    if (!a.is_dense() && !b.is_dense()) {
+        set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                         back_inserter(result.array));
+    }
+    else if (!a.is_dense() || !b.is_dense()) {
+        // Массив фильтруется проверкой битов плотного блока
+        const Container& sparse = a.is_dense() ? b : a;
+        const Container& dense = a.is_dense() ? a : b;
+        for (uint16_t v : sparse.array) {
+            if (dense.words[v >> 6] & (uint64_t{1} << (v & 63))) {
+                result.array.push_back(v);
+            }
+        }
+    }
+    else {
+        result.words.resize(WORDS);
+        for (size_t i = 0; i < WORDS; ++i) {
+            result.words[i] = a.words[i] & b.words[i];
+        }
+    }
+
+    result.normalize();
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+
+    if (!a.is_dense() && !b.is_dense()) {
+        set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                  back_inserter(result.array));
+    }
+    else {
+        vector<uint64_t> other;
+        const Container& dense = a.is_dense() ? a : b;
+        const Container& rest = a.is_dense() ? b : a;
+        rest.to_words(other);
+        result.words.resize(WORDS);
+        for (size_t i = 0; i < WORDS; ++i) {
+            result.words[i] = dense.words[i] | other[i];
+        }
+    }
+
+    result.normalize();
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::subtract(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+
+    if (!a.is_dense()) {
+        if (b.is_dense()) {
+            for (uint16_t v : a.array) {
+                if (!(b.words[v >> 6] & (uint64_t{1} << (v & 63)))) {
+                    result.array.push_back(v);
+                }
+            }
+        }
+        else {
+            set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                           back_inserter(result.array));
+        }
+    }
+    else {
+        vector<uint64_t> other;
+        b.to_words(other);
+        result.words.resize(WORDS);
+        for (size_t i = 0; i < WORDS; ++i) {
+            result.words[i] = a.words[i] & ~other[i];
+        }
+    }
+
+    result.normalize();
+    return result;
+}
+
+// ============================================
+// RoaringBitmap: операции над набором
+// ============================================
+
+RoaringBitmap::Container* RoaringBitmap::find_container(uint16_t key) {
+    auto it = lower_bound(containers.begin(), containers.end(), key,
+                          [](const Container& c, uint16_t k) { return c.key < k; });
+    return (it != containers.end() && it->key == key) ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::find_container(uint16_t key) const {
+    auto it = lower_bound(containers.begin(), containers.end(), key,
+                          [](const Container& c, uint16_t k) { return c.key < k; });
+    return (it != containers.end() && it->key == key) ? &*it : nullptr;
+}
+
+void RoaringBitmap::add(uint32_t row) {
+    uint16_t key = static_cast<uint16_t>(row >> 16);
+    uint16_t low = static_cast<uint16_t>(row & 0xFFFF);
+
+    // Индексы строятся обходом строк по возрастанию, поэтому чаще всего нужен последний блок
+    Container* c = nullptr;
+    if (!containers.empty() && containers.back().key == key) {
+        c = &containers.back();
+    }
+    else {
+        c = find_container(key);
+        if (c == nullptr) {
+            auto it = lower_bound(containers.begin(), containers.end(), key,
+                                  [](const Container& x, uint16_t k) { return x.key < k; });
+            it = containers.insert(it, Container());
+            it->key = key;
+            c = &*it;
+        }
+    }
+
+    if (c->is_dense()) {
+        uint64_t bit = uint64_t{1} << (low & 63);
+        if (!(c->words[low >> 6] & bit)) {
+            c->words[low >> 6] |= bit;
+            c->cardinality++;
+        }
+        return;
+    }
+
+    if (c->array.empty() || c->array.back() < low) {
+        c->array.push_back(low);
+    }
+    else {
+        auto pos = lower_bound(c->array.begin(), c->array.end(), low);
+        if (*pos == low) return;
+        c->array.insert(pos, low);
+    }
+    c->normalize();
+}
+
+bool RoaringBitmap::contains(uint32_t row) const {
+    const Container* c = find_container(static_cast<uint16_t>(row >> 16));
+    if (c == nullptr) return false;
+    uint16_t low = static_cast<uint16_t>(row & 0xFFFF);
+    if (c->is_dense()) {
+        return (c->words[low >> 6] >> (low & 63)) & 1;
+    }
+    return binary_search(c->array.begin(), c->array.end(), low);
+}
+
+size_t RoaringBitmap::cardinality() const {
+    size_t total = 0;
+    for (const auto& c : containers) {
+        total += c.cardinality;
+    }
+    return total;
+}
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < containers.size() && j < other.containers.size()) {
+        if (containers[i].key < other.containers[j].key) {
+            i++;
+        }
+        else if (containers[i].key > other.containers[j].key) {
+            j++;
+        }
+        else {
+            Container c = intersect(containers[i], other.containers[j]);
+            if (c.cardinality > 0) result.containers.push_back(std::move(c));
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < containers.size() || j < other.containers.size()) {
+        if (j == other.containers.size() ||
+            (i < containers.size() && containers[i].key < other.containers[j].key)) {
+            result.containers.push_back(containers[i++]);
+        }
+        else if (i == containers.size() || other.containers[j].key < containers[i].key) {
+            result.containers.push_back(other.containers[j++]);
+        }
+        else {
+            result.containers.push_back(unite(containers[i++], other.containers[j++]));
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::and_not(const RoaringBitmap& other) const {
+    RoaringBitmap result;
+    size_t j = 0;
+    for (const auto& c : containers) {
+        while (j < other.containers.size() && other.containers[j].key < c.key) {
+            j++;
+        }
+        if (j < other.containers.size() && other.containers[j].key == c.key) {
+            Container diff = subtract(c, other.containers[j]);
+            if (diff.cardinality > 0) result.containers.push_back(std::move(diff));
+        }
+        else {
+            result.containers.push_back(c);
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::complement(uint32_t universe) const {
+    RoaringBitmap full;
+    for (uint64_t start = 0; start < universe; start += uint64_t{1} << 16) {
+        Container c;
+        c.key = static_cast<uint16_t>(start >> 16);
+        c.words.assign(WORDS, ~uint64_t{0});
+        uint64_t bits = min<uint64_t>(universe - start, uint64_t{1} << 16);
+        if (bits < (uint64_t{1} << 16)) {
+            size_t full_words = bits / 64;
+            for (size_t i = full_words; i < WORDS; ++i) c.words[i] = 0;
+            if (bits % 64 != 0) c.words[full_words] = (uint64_t{1} << (bits % 64)) - 1;
+        }
+        c.normalize();
+        full.containers.push_back(std::move(c));
+    }
+    return full.and_not(*this);
+}
+
+vector<uint32_t> RoaringBitmap::to_rows() const {
+    vector<uint32_t> rows;
+    rows.reserve(cardinality());
+    for (const auto& c : containers) {
+        uint32_t high = static_cast<uint32_t>(c.key) << 16;
+        if (c.is_dense()) {
+            for (size_t i = 0; i < WORDS; ++i) {
+                uint64_t w = c.words[i];
+                while (w != 0) {
+                    rows.push_back(high | static_cast<uint32_t>(i * 64 + __builtin_ctzll(w)));
+                    w &= w - 1;
+                }
+            }
+        }
+        else {
+            for (uint16_t v : c.array) {
+                rows.push_back(high | v);
+            }
+        }
+    }
+    return rows;
+}
+
+size_t RoaringBitmap::memory_bytes() const {
+    size_t bytes = containers.capacity() * sizeof(Container);
+    for (const auto& c : containers) {
+        bytes += c.array.capacity() * sizeof(uint16_t) + c.words.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+// ============================================
+// FlightBitmapIndex
+// ============================================
+
+void FlightBitmapIndex::build(const FlightUnorderedSet& flights) {
+    clear();
+    rows.reserve(flights.size());
+    flags.resize(static_cast<size_t>(FlightFlag::LateAircraftDelay) + 1);
+
+    uint32_t row = 0;
+    for (const auto& f : flights) {
+        rows.push_back(&f);
+
+        if (f.is_canceled()) flags[static_cast<size_t>(FlightFlag::Canceled)].add(row);
+        if (f.is_diverted()) flags[static_cast<size_t>(FlightFlag::Diverted)].add(row);
+        if (f.hasCarrierDelay()) flags[static_cast<size_t>(FlightFlag::CarrierDelay)].add(row);
+        if (f.hasWeatherDelay()) flags[static_cast<size_t>(FlightFlag::WeatherDelay)].add(row);
+        if (f.hasNasDelay()) flags[static_cast<size_t>(FlightFlag::NasDelay)].add(row);
+        if (f.hasSecurityDelay()) flags[static_cast<size_t>(FlightFlag::SecurityDelay)].add(row);
+        if (f.hasLateAircraftDelay()) flags[static_cast<size_t>(FlightFlag::LateAircraftDelay)].add(row);
+
+        cancellation_codes[f.get_cancellation_code()].add(row);
+        week_days[f.get_week_day()].add(row);
+        months[f.get_month()].add(row);
+        row++;
+    }
+}
+
+void FlightBitmapIndex::clear() {
+    rows.clear();
+    flags.clear();
+    cancellation_codes.clear();
+    week_days.clear();
+    months.clear();
+}
+
+const RoaringBitmap& FlightBitmapIndex::lookup(const map<int, RoaringBitmap>& column, int value) {
+    static const RoaringBitmap empty_bitmap;
+    auto it = column.find(value);
+    return it == column.end() ? empty_bitmap : it->second;
+}
+
+const RoaringBitmap& FlightBitmapIndex::by_flag(FlightFlag flag) const {
+    static const RoaringBitmap empty_bitmap;
+    size_t pos = static_cast<size_t>(flag);
+    return pos < flags.size() ? flags[pos] : empty_bitmap;
+}
+
+const RoaringBitmap& FlightBitmapIndex::by_cancellation_code(char code) const {
+    return lookup(cancellation_codes, code);
+}
+
+const RoaringBitmap& FlightBitmapIndex::by_week_day(int week_day) const {
+    return lookup(week_days, week_day);
+}
+
+const RoaringBitmap& FlightBitmapIndex::by_month(int month) const {
+    return lookup(months, month);
+}
+
+RoaringBitmap FlightBitmapIndex::negate(const RoaringBitmap& bitmap) const {
+    return bitmap.complement(static_cast<uint32_t>(rows.size()));
+}
+
+vector<const flight*> FlightBitmapIndex::get_flights(const RoaringBitmap& bitmap) const {
+    vector<const flight*> result;
+    result.reserve(bitmap.cardinality());
+    for (uint32_t row : bitmap.to_rows()) {
+        result.push_back(rows[row]);
+    }
+    return result;
+}
+
+size_t FlightBitmapIndex::memory_bytes() const {
+    size_t bytes = rows.capacity() * sizeof(const flight*);
+    for (const auto& b : flags) bytes += b.memory_bytes();
+    for (const auto& [code, b] : cancellation_codes) bytes += b.memory_bytes();
+    for (const auto& [day, b] : week_days) bytes += b.memory_bytes();
+    for (const auto& [month, b] : months) bytes += b.memory_bytes();
+    return bytes;
+}
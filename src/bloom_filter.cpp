@@ -0,0 +1,87 @@
+#include "bloom_filter.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+// Перемешивание splitmix64: младшие и старшие биты результата независимы
+static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+BloomFilter::BloomFilter(size_t expected_items, double false_positive_rate) {
+    double p = min(max(false_positive_rate, 1e-9), 0.5);
+    double n = static_cast<double>(max<size_t>(expected_items, 1));
+    // Оптимум для обычного фильтра: m = -n ln p / ln^2 2 бит, k = m / n * ln 2.
+    // Блочный фильтр распределяет ключи по блокам неравномерно, и чем меньше p, тем
+    // сильнее это сказывается, поэтому бит берется больше: +12.5% на каждый порядок p
+    const double LN2 = 0.6931471805599453;
+    double bits = -n * log(p) / (LN2 * LN2) * (1.0 - 0.125 * log10(p));
+    blocks = max<size_t>(1, static_cast<size_t>(ceil(bits / (BLOCK_WORDS * 64))));
+    hash_count = static_cast<unsigned>(min(16.0, max(1.0, round(-log(p) / LN2))));
+    words.assign(blocks * BLOCK_WORDS, 0);
+}
+
+// Блок выбирается старшими 32 битами хеша, каждая позиция в блоке - отдельными
+// 9 битами перемешанного хеша (по 7 позиций на 64 бита, затем хеш перемешивается снова).
+// Двойное хеширование (h1 + i * h2) mod 512 дает слишком мало различных наборов
+// позиций, и при малых p доля ложных срабатываний упирается в этот предел
+template<typename Visit>
+static bool for_each_bit(uint64_t hash, unsigned hash_count, Visit visit) {
+    uint64_t h = mix(hash);
+    for (unsigned i = 0; i < hash_count; ++i) {
+        if (i > 0 && i % 7 == 0) h = mix(h);
+        if (!visit(static_cast<uint32_t>(h & 511))) return false;
+        h >>= 9;
+    }
+    return true;
+}
+
+void BloomFilter::add(uint64_t hash) {
+    if (blocks == 0) return;
+    uint64_t* block = words.data() + ((hash >> 32) * blocks >> 32) * BLOCK_WORDS;
+    for_each_bit(hash, hash_count, [block](uint32_t bit) {
+        block[bit >> 6] |= uint64_t{1} << (bit & 63);
+        return true;
+    });
+    items++;
+}
+
+bool BloomFilter::might_contain(uint64_t hash) const {
+    if (blocks == 0) return false;
+    const uint64_t* block = words.data() + ((hash >> 32) * blocks >> 32) * BLOCK_WORDS;
+    return for_each_bit(hash, hash_count, [block](uint32_t bit) {
+        return (block[bit >> 6] & (uint64_t{1} << (bit & 63))) != 0;
+    });
+}
+
+void BloomFilter::clear() {
+    fill(words.begin(), words.end(), 0);
+    items = 0;
+}
+
+double BloomFilter::estimated_false_positive_rate() const {
+    if (blocks == 0) return 1.0;
+    double fill_share = 0.0;
+    for (uint64_t w : words) {
+        fill_share += __builtin_popcountll(w);
+    }
+    fill_share /= static_cast<double>(words.size() * 64);
+    return pow(fill_share, hash_count);
+}
+
+uint64_t flight_key_hash(string_view unique_key) {
+    return mix(hash<string_view>()(unique_key));
+}
+
+uint64_t flight_key_hash(const flight& f) {
+    thread_local string key;
+    key.clear();
+    f.append_unique_key(key);
+    return flight_key_hash(string_view(key));
+}
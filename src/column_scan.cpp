@@ -0,0 +1,173 @@
+#include "column_scan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COLUMN_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+vector<float> extract_arr_delay(const vector<flight>& flights) {
+    return extract_column(flights, [](const flight& f) { return f.get_arr_delay(); });
+}
+
+// ============================================
+// Приемники результата: список индексов или битовая маска.
+// block(base, mask) - совпадения среди values[base, base + 8), one(i) - одно совпадение
+// ============================================
+
+struct IndexSink {
+    vector<size_t>& out;
+    size_t added = 0;
+
+    void block(size_t base, unsigned mask) {
+        while (mask != 0) {
+            out.push_back(base + __builtin_ctz(mask));
+            mask &= mask - 1;
+            added++;
+        }
+    }
+
+    void one(size_t i) {
+        out.push_back(i);
+        added++;
+    }
+};
+
+struct MaskSink {
+    vector<uint64_t>& bits;
+
+    // base кратно 8, поэтому 8 бит блока не пересекают границу слова
+    void block(size_t base, unsigned mask) {
+        bits[base / 64] |= static_cast<uint64_t>(mask) << (base % 64);
+    }
+
+    void one(size_t i) {
+        bits[i / 64] |= uint64_t{1} << (i % 64);
+    }
+};
+
+template<typename T>
+static bool matches(T v, ColumnPredicate op, T a, T b) {
+    switch (op) {
+        case ColumnPredicate::Equal: return v == a;
+        case ColumnPredicate::Less: return v < a;
+        case ColumnPredicate::GreaterEqual: return v >= a;
+        case ColumnPredicate::Between: return a <= v && v <= b;
+    }
+    return false;
+}
+
+template<typename T, typename Sink>
+static void scan_scalar(const T* values, size_t begin, size_t n, ColumnPredicate op, T a, T b, Sink& sink) {
+    for (size_t i = begin; i < n; ++i) {
+        if (matches(values[i], op, a, b)) {
+            sink.one(i);
+        }
+    }
+}
+
+#ifdef COLUMN_SCAN_X86
+// 8 сравнений за инструкцию; маска совпадений разбирается по битам,
+// поэтому блоки без совпадений пропускаются без ветвлений на каждый элемент
+template<typename Sink>
+__attribute__((target("avx2")))
+static void scan_avx2(const float* values, size_t n, ColumnPredicate op, float a, float b, Sink& sink) {
+    const __m256 limit_a = _mm256_set1_ps(a);
+    const __m256 limit_b = _mm256_set1_ps(b);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 block = _mm256_loadu_ps(values + i);
+        __m256 hit;
+        switch (op) {
+            case ColumnPredicate::Equal: hit = _mm256_cmp_ps(block, limit_a, _CMP_EQ_OQ); break;
+            case ColumnPredicate::Less: hit = _mm256_cmp_ps(block, limit_a, _CMP_LT_OQ); break;
+            case ColumnPredicate::GreaterEqual: hit = _mm256_cmp_ps(block, limit_a, _CMP_GE_OQ); break;
+            default:
+                hit = _mm256_and_ps(_mm256_cmp_ps(block, limit_a, _CMP_GE_OQ),
+                                    _mm256_cmp_ps(block, limit_b, _CMP_LE_OQ));
+                break;
+        }
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(hit));
+        if (mask != 0) sink.block(i, mask);
+    }
+    scan_scalar(values, i, n, op, a, b, sink);
+}
+
+// У целых есть только == и >, остальные условия получаются отрицанием
+template<typename Sink>
+__attribute__((target("avx2")))
+static void scan_avx2(const int32_t* values, size_t n, ColumnPredicate op, int32_t a, int32_t b, Sink& sink) {
+    const __m256i limit_a = _mm256_set1_epi32(a);
+    const __m256i limit_b = _mm256_set1_epi32(b);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i hit;
+        bool negate = false;
+        switch (op) {
+            case ColumnPredicate::Equal: hit = _mm256_cmpeq_epi32(block, limit_a); break;
+            case ColumnPredicate::Less: hit = _mm256_cmpgt_epi32(limit_a, block); break;
+            case ColumnPredicate::GreaterEqual:
+                hit = _mm256_cmpgt_epi32(limit_a, block);
+                negate = true;
+                break;
+            default:
+                hit = _mm256_or_si256(_mm256_cmpgt_epi32(limit_a, block), _mm256_cmpgt_epi32(block, limit_b));
+                negate = true;
+                break;
+        }
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+        if (negate) mask = ~mask & 0xFFu;
+        if (mask != 0) sink.block(i, mask);
+    }
+    scan_scalar(values, i, n, op, a, b, sink);
+}
+#endif
+
+bool column_scan_uses_avx2() {
+#ifdef COLUMN_SCAN_X86
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+template<typename T, typename Sink>
+static void scan(const T* values, size_t n, ColumnPredicate op, T a, T b, Sink& sink) {
+#ifdef COLUMN_SCAN_X86
+    if (column_scan_uses_avx2()) {
+        scan_avx2(values, n, op, a, b, sink);
+        return;
+    }
+#endif
+    scan_scalar(values, 0, n, op, a, b, sink);
+}
+
+size_t column_select(const float* values, size_t n, ColumnPredicate op, float a, float b, vector<size_t>& out) {
+    IndexSink sink{out};
+    scan(values, n, op, a, b, sink);
+    return sink.added;
+}
+
+size_t column_select(const int32_t* values, size_t n, ColumnPredicate op, int32_t a, int32_t b,
+                     vector<size_t>& out) {
+    IndexSink sink{out};
+    scan(values, n, op, a, b, sink);
+    return sink.added;
+}
+
+vector<uint64_t> column_mask(const float* values, size_t n, ColumnPredicate op, float a, float b) {
+    vector<uint64_t> bits((n + 63) / 64, 0);
+    MaskSink sink{bits};
+    scan(values, n, op, a, b, sink);
+    return bits;
+}
+
+vector<uint64_t> column_mask(const int32_t* values, size_t n, ColumnPredicate op, int32_t a, int32_t b) {
+    vector<uint64_t> bits((n + 63) / 64, 0);
+    MaskSink sink{bits};
+    scan(values, n, op, a, b, sink);
+    return bits;
+}
@@ -0,0 +1,192 @@
+#include "concurrent_flight_organizer.h"
+
+using namespace std;
+
+namespace {
+    // Снимок, который поток видел последним, и его версия
+    struct SnapshotCache {
+        uint64_t owner = 0;
+        uint64_t version = 0;
+        shared_ptr<const ConcurrentFlightOrganizer::Snapshot> snapshot;
+    };
+
+    thread_local SnapshotCache snapshot_cache;
+    atomic<uint64_t> next_instance_id{1};
+}
+
+ConcurrentFlightOrganizer::Segment::Segment(vector<flight> data) : flights(std::move(data)) {
+    by_key.reserve(flights.size());
+    for (uint32_t i = 0; i < flights.size(); ++i) {
+        const flight& f = flights[i];
+        by_key.emplace(f.get_unique_key(), i);
+        by_carrier[f.get_carrier_id()].push_back(i);
+        by_aircraft[aircraft_key(f.get_carrier_id(), f.get_flight_number())].push_back(i);
+    }
+}
+
+string ConcurrentFlightOrganizer::aircraft_key(const string& carrier_id, float flight_number) {
+    return carrier_id + "_" + to_string(static_cast<int>(flight_number));
+}
+
+// ============================================
+// Snapshot
+// ============================================
+
+const flight* ConcurrentFlightOrganizer::Snapshot::find(const string& key) const {
+    for (const auto& segment : segments) {
+        auto it = segment->by_key.find(key);
+        if (it != segment->by_key.end()) {
+            return &segment->flights[it->second];
+        }
+    }
+    return nullptr;
+}
+
+bool ConcurrentFlightOrganizer::Snapshot::contains(const string& key) const {
+    return find(key) != nullptr;
+}
+
+vector<const flight*> ConcurrentFlightOrganizer::Snapshot::get_flights_by_carrier(const string& carrier_id) const {
+    vector<const flight*> result;
+    for (const auto& segment : segments) {
+        auto it = segment->by_carrier.find(carrier_id);
+        if (it == segment->by_carrier.end()) continue;
+        for (uint32_t i : it->second) {
+            result.push_back(&segment->flights[i]);
+        }
+    }
+    return result;
+}
+
+vector<const flight*> ConcurrentFlightOrganizer::Snapshot::get_flights_by_aircraft(const string& carrier_id,
+                                                                                    float flight_number) const {
+    vector<const flight*> result;
+    string key = aircraft_key(carrier_id, flight_number);
+    for (const auto& segment : segments) {
+        auto it = segment->by_aircraft.find(key);
+        if (it == segment->by_aircraft.end()) continue;
+        for (uint32_t i : it->second) {
+            result.push_back(&segment->flights[i]);
+        }
+    }
+    return result;
+}
+
+// ============================================
+// Писатель
+// ============================================
+
+ConcurrentFlightOrganizer::ConcurrentFlightOrganizer(size_t publish_batch)
+    : instance_id(next_instance_id.fetch_add(1)), current(make_shared<const Snapshot>()),
+      publish_batch(publish_batch == 0 ? 1 : publish_batch) {}
+
+// Кэши других потоков отсюда недоступны; свой освобождается сразу
+ConcurrentFlightOrganizer::~ConcurrentFlightOrganizer() {
+    if (snapshot_cache.owner == instance_id) {
+        snapshot_cache = SnapshotCache();
+    }
+}
+
+bool ConcurrentFlightOrganizer::add_flight(const flight& f) {
+    lock_guard<mutex> lock(writer_mutex);
+    if (!known_keys.insert(f.get_unique_key()).second) {
+        return false;
+    }
+    pending.push_back(f);
+    if (pending.size() >= publish_batch) {
+        publish_pending();
+    }
+    return true;
+}
+
+void ConcurrentFlightOrganizer::publish() {
+    lock_guard<mutex> lock(writer_mutex);
+    publish_pending();
+}
+
+void ConcurrentFlightOrganizer::publish_pending() {
+    if (pending.empty()) {
+        return;
+    }
+
+    // Сегменты только читаются, поэтому новый снимок разделяет их со старым.
+    // current меняет только писатель, поэтому читать его здесь можно без publish_mutex
+    auto next = make_shared<Snapshot>(*current);
+
+    vector<flight> data;
+    data.swap(pending);
+    next->total += data.size();
+    next->segments.push_back(make_shared<const Segment>(std::move(data)));
+
+    // Слияние хвостовых сегментов сопоставимого размера (как в LSM-дереве):
+    // число сегментов остается O(log n), а каждый рейс копируется O(log n) раз
+    while (next->segments.size() >= 2) {
+        const auto& newer = next->segments[next->segments.size() - 1];
+        const auto& older = next->segments[next->segments.size() - 2];
+        if (newer->flights.size() * 2 < older->flights.size()) {
+            break;
+        }
+        vector<flight> merged;
+        merged.reserve(older->flights.size() + newer->flights.size());
+        merged.insert(merged.end(), older->flights.begin(), older->flights.end());
+        merged.insert(merged.end(), newer->flights.begin(), newer->flights.end());
+        next->segments.pop_back();
+        next->segments.back() = make_shared<const Segment>(std::move(merged));
+    }
+
+    // Старый снимок освобождается после снятия блокировки
+    shared_ptr<const Snapshot> retired;
+    {
+        lock_guard<mutex> lock(publish_mutex);
+        retired = std::move(current);
+        current = std::move(next);
+        version.fetch_add(1, memory_order_release);
+    }
+}
+
+// ============================================
+// Читатели
+// ============================================
+
+const shared_ptr<const ConcurrentFlightOrganizer::Snapshot>& ConcurrentFlightOrganizer::cached_snapshot() const {
+    SnapshotCache& cache = snapshot_cache;
+    if (cache.owner != instance_id || cache.version != version.load(memory_order_acquire)) {
+        // Если поток держал последнюю ссылку на старый снимок, тот освобождается после снятия блокировки
+        shared_ptr<const Snapshot> previous = std::move(cache.snapshot);
+        lock_guard<mutex> lock(publish_mutex);
+        cache.snapshot = current;
+        cache.version = version.load(memory_order_relaxed);
+        cache.owner = instance_id;
+    }
+    return cache.snapshot;
+}
+
+shared_ptr<const ConcurrentFlightOrganizer::Snapshot> ConcurrentFlightOrganizer::snapshot() const {
+    return cached_snapshot();
+}
+
+size_t ConcurrentFlightOrganizer::get_unique_flights_count() const {
+    return cached_snapshot()->get_unique_flights_count();
+}
+
+bool ConcurrentFlightOrganizer::contains(const string& key) const {
+    return cached_snapshot()->contains(key);
+}
+
+vector<flight> ConcurrentFlightOrganizer::copy_flights(const vector<const flight*>& pointers) {
+    vector<flight> result;
+    result.reserve(pointers.size());
+    for (const flight* f : pointers) {
+        result.push_back(*f);
+    }
+    return result;
+}
+
+vector<flight> ConcurrentFlightOrganizer::get_flights_by_carrier(const string& carrier_id) const {
+    // Снимок из кэша потока живет до конца копирования: обновить кэш может только этот поток
+    return copy_flights(cached_snapshot()->get_flights_by_carrier(carrier_id));
+}
+
+vector<flight> ConcurrentFlightOrganizer::get_flights_by_aircraft(const string& carrier_id, float flight_number) const {
+    return copy_flights(cached_snapshot()->get_flights_by_aircraft(carrier_id, flight_number));
+}
@@ -0,0 +1,394 @@
+#include "external_sort.h"
+#include "compression.h"
+#include "sort_keys.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// ============================================
+// Формат серии: блоки [исходный размер u32][размер в файле u32][данные],
+// данные блока - записи [ключ u64][длина u32][байты строки].
+// При compress_runs данные блока сжаты LZSSCompressor
+// ============================================
+
+static const size_t RUN_BLOCK_BYTES = 1024 * 1024;
+static const size_t OUTPUT_FLUSH_BYTES = 4 * 1024 * 1024;
+
+class RunWriter {
+public:
+    RunWriter(const string& filename, bool compress)
+        : out(filename, ios::binary), compress(compress) {
+        block.reserve(RUN_BLOCK_BYTES + 1024);
+    }
+
+    bool is_open() const { return out.is_open(); }
+
+    void add(uint64_t key, const char* line, size_t size) {
+        uint32_t length = static_cast<uint32_t>(size);
+        block.append(reinterpret_cast<const char*>(&key), sizeof(key));
+        block.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        block.append(line, size);
+        if (block.size() >= RUN_BLOCK_BYTES) {
+            flush_block();
+        }
+    }
+
+    // Возвращает false при ошибке записи
+    bool finish() {
+        flush_block();
+        out.close();
+        return !out.fail();
+    }
+
+    uint64_t get_written_bytes() const { return written; }
+
+private:
+    void flush_block() {
+        if (block.empty()) return;
+        uint32_t original_size = static_cast<uint32_t>(block.size());
+        if (compress) {
+            vector<uint8_t> raw(block.begin(), block.end());
+            vector<uint8_t> packed = compressor.compress(raw);
+            write_block(original_size, reinterpret_cast<const char*>(packed.data()), packed.size());
+        }
+        else {
+            write_block(original_size, block.data(), block.size());
+        }
+        block.clear();
+    }
+
+    void write_block(uint32_t original_size, const char* data, size_t size) {
+        uint32_t stored_size = static_cast<uint32_t>(size);
+        out.write(reinterpret_cast<const char*>(&original_size), 4);
+        out.write(reinterpret_cast<const char*>(&stored_size), 4);
+        out.write(data, static_cast<streamsize>(size));
+        written += 8 + size;
+    }
+
+    ofstream out;
+    bool compress;
+    LZSSCompressor compressor;
+    string block;
+    uint64_t written = 0;
+};
+
+class RunReader {
+public:
+    RunReader(const string& filename, bool compress)
+        : in(filename, ios::binary), compress(compress) {}
+
+    bool is_open() const { return in.is_open(); }
+
+    // Переходит к следующей записи; false - серия закончилась
+    bool next() {
+        if (pos >= block.size() && !load_block()) {
+            return false;
+        }
+        uint32_t length;
+        memcpy(&key, block.data() + pos, sizeof(key));
+        memcpy(&length, block.data() + pos + sizeof(key), sizeof(length));
+        pos += sizeof(key) + sizeof(length);
+        line = reinterpret_cast<const char*>(block.data() + pos);
+        line_size = length;
+        pos += length;
+        return true;
+    }
+
+    uint64_t key = 0;
+    const char* line = nullptr;     // указывает в текущий блок, действителен до next()
+    size_t line_size = 0;
+
+private:
+    bool load_block() {
+        uint32_t original_size = 0;
+        uint32_t stored_size = 0;
+        if (!in.read(reinterpret_cast<char*>(&original_size), 4) ||
+            !in.read(reinterpret_cast<char*>(&stored_size), 4)) {
+            return false;
+        }
+        vector<uint8_t> stored(stored_size);
+        if (!in.read(reinterpret_cast<char*>(stored.data()), stored_size)) {
+            cerr << "Unexpected end of run file" << endl;
+            return false;
+        }
+        block = compress ? compressor.decompress(stored) : move(stored);
+        if (block.size() != original_size) {
+            cerr << "Corrupted run block: " << block.size() << " != " << original_size << endl;
+            return false;
+        }
+        pos = 0;
+        return !block.empty();
+    }
+
+    ifstream in;
+    bool compress;
+    LZSSCompressor compressor;
+    vector<uint8_t> block;
+    size_t pos = 0;
+};
+
+// ============================================
+// Дерево проигравших: в узлах хранятся проигравшие в своих поддеревьях,
+// в tree[0] - победитель. После выдачи записи победителя достаточно
+// одного прохода от его листа к корню: log2(k) сравнений
+// ============================================
+
+class LoserTree {
+public:
+    explicit LoserTree(vector<unique_ptr<RunReader>>& runs)
+        : runs(runs), k(runs.size()), tree(runs.size(), runs.size()), exhausted(runs.size(), false) {
+        for (size_t i = 0; i < k; ++i) {
+            exhausted[i] = !runs[i]->next();
+        }
+        // Индекс k - фиктивный участник "минус бесконечность", он вытесняется при построении
+        for (size_t i = k; i-- > 0;) {
+            adjust(i);
+        }
+    }
+
+    bool empty() const { return k == 0 || exhausted[tree[0]]; }
+    RunReader& top() { return *runs[tree[0]]; }
+
+    void pop() {
+        size_t winner = tree[0];
+        exhausted[winner] = !runs[winner]->next();
+        adjust(winner);
+    }
+
+private:
+    // Запись серии a идет раньше записи серии b; при равных ключах раньше более ранняя серия
+    bool before(size_t a, size_t b) const {
+        if (a == k) return true;
+        if (b == k) return false;
+        if (exhausted[a]) return false;
+        if (exhausted[b]) return true;
+        uint64_t x = runs[a]->key;
+        uint64_t y = runs[b]->key;
+        return x < y || (x == y && a < b);
+    }
+
+    void adjust(size_t leaf) {
+        size_t winner = leaf;
+        for (size_t node = (leaf + k) / 2; node > 0; node /= 2) {
+            if (before(tree[node], winner)) {
+                swap(winner, tree[node]);
+            }
+        }
+        tree[0] = winner;
+    }
+
+    vector<unique_ptr<RunReader>>& runs;
+    size_t k;
+    vector<size_t> tree;
+    vector<bool> exhausted;
+};
+
+// ============================================
+// Сортировка
+// ============================================
+
+static string run_file_name(const string& output_file, const ExternalSortOptions& options, size_t run) {
+    string base = output_file;
+    if (!options.temp_dir.empty()) {
+        size_t slash = output_file.find_last_of("/\\");
+        base = options.temp_dir + "/" + (slash == string::npos ? output_file : output_file.substr(slash + 1));
+    }
+    return base + ".run" + to_string(run);
+}
+
+static void remove_runs(const vector<string>& run_files) {
+    for (const auto& name : run_files) {
+        remove(name.c_str());
+    }
+}
+
+// Сливает серии и передает записи по порядку в sink(key, line, size).
+// Возвращает число записей или -1, если серию не удалось открыть
+template<typename Sink>
+static long long merge_runs(const vector<string>& run_files, bool compress, Sink sink) {
+    vector<unique_ptr<RunReader>> readers;
+    for (const auto& name : run_files) {
+        readers.push_back(make_unique<RunReader>(name, compress));
+        if (!readers.back()->is_open()) {
+            cerr << "Cannot open run file: " << name << endl;
+            return -1;
+        }
+    }
+    long long merged = 0;
+    for (LoserTree tree(readers); !tree.empty(); tree.pop()) {
+        const RunReader& run = tree.top();
+        sink(run.key, run.line, run.line_size);
+        merged++;
+    }
+    return merged;
+}
+
+static void flush_output(ofstream& out, string& buffer) {
+    out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+ExternalSortStats external_sort_csv(const string& input_file, const string& output_file,
+                                    const ExternalSortKey& key_of, const ExternalSortOptions& options) {
+    ExternalSortStats stats;
+
+    ifstream in(input_file, ios::binary);
+    if (!in.is_open()) {
+        cerr << "File is unavailable to load: " << input_file << endl;
+        return stats;
+    }
+
+    string header;
+    bool has_header = options.has_header && static_cast<bool>(getline(in, header));
+
+    // Порция строк в памяти и их ключи (индекс строки делает сортировку устойчивой)
+    vector<string> lines;
+    vector<pair<uint64_t, uint32_t>> keys;
+    vector<string> run_files;
+    size_t chunk_bytes = 0;
+
+    auto sort_chunk = [&]() {
+        keys.clear();
+        keys.reserve(lines.size());
+        for (uint32_t i = 0; i < lines.size(); ++i) {
+            keys.emplace_back(key_of(lines[i]), i);
+        }
+        sort(keys.begin(), keys.end());
+    };
+
+    auto spill_chunk = [&]() -> bool {
+        sort_chunk();
+        string name = run_file_name(output_file, options, run_files.size());
+        run_files.push_back(name);
+        RunWriter writer(name, options.compress_runs);
+        if (!writer.is_open()) {
+            cerr << "Cannot create run file: " << name << endl;
+            return false;
+        }
+        for (const auto& entry : keys) {
+            const string& chunk_line = lines[entry.second];
+            writer.add(entry.first, chunk_line.data(), chunk_line.size());
+        }
+        if (!writer.finish()) {
+            cerr << "Cannot write run file: " << name << endl;
+            return false;
+        }
+        stats.spilled_bytes += writer.get_written_bytes();
+        lines.clear();
+        chunk_bytes = 0;
+        return true;
+    };
+
+    string line;
+    while (getline(in, line)) {
+        chunk_bytes += line.size() + sizeof(string) + sizeof(pair<uint64_t, uint32_t>);
+        lines.push_back(move(line));
+        stats.records++;
+        if (chunk_bytes >= options.memory_limit && !spill_chunk()) {
+            remove_runs(run_files);
+            return stats;
+        }
+    }
+    // Последняя порция сбрасывается, только если уже есть другие серии
+    if (!run_files.empty() && !lines.empty() && !spill_chunk()) {
+        remove_runs(run_files);
+        return stats;
+    }
+    in.close();
+    stats.runs = run_files.size();
+
+    // Если серий больше, чем можно открыть разом, они сливаются группами
+    // в промежуточные серии (соседние группы - устойчивость сохраняется)
+    size_t fan_in = max<size_t>(2, options.max_merge_fan_in);
+    size_t next_run = run_files.size();
+    while (run_files.size() > fan_in) {
+        vector<string> merged_files;
+        for (size_t i = 0; i < run_files.size(); i += fan_in) {
+            vector<string> group(run_files.begin() + i, run_files.begin() + min(run_files.size(), i + fan_in));
+            string name = run_file_name(output_file, options, next_run++);
+            merged_files.push_back(name);
+            RunWriter writer(name, options.compress_runs);
+            long long merged = -1;
+            if (writer.is_open()) {
+                merged = merge_runs(group, options.compress_runs, [&](uint64_t key, const char* line, size_t size) {
+                    writer.add(key, line, size);
+                });
+            }
+            if (merged < 0 || !writer.finish()) {
+                cerr << "Cannot write run file: " << name << endl;
+                remove_runs(run_files);
+                remove_runs(merged_files);
+                return stats;
+            }
+            stats.spilled_bytes += writer.get_written_bytes();
+            remove_runs(group);
+        }
+        run_files = move(merged_files);
+        stats.merge_passes++;
+    }
+
+    ofstream out(output_file, ios::binary);
+    if (!out.is_open()) {
+        cerr << "Cannot open file for writing: " << output_file << endl;
+        remove_runs(run_files);
+        return stats;
+    }
+    string buffer;
+    buffer.reserve(OUTPUT_FLUSH_BYTES + 1024);
+    if (has_header) {
+        buffer.append(header);
+        buffer += '\n';
+    }
+
+    if (run_files.empty()) {
+        // Все поместилось в память - обычная сортировка без временных файлов
+        sort_chunk();
+        for (const auto& entry : keys) {
+            buffer.append(lines[entry.second]);
+            buffer += '\n';
+            if (buffer.size() >= OUTPUT_FLUSH_BYTES) flush_output(out, buffer);
+        }
+    }
+    else {
+        long long merged = merge_runs(run_files, options.compress_runs, [&](uint64_t, const char* line, size_t size) {
+            buffer.append(line, size);
+            buffer += '\n';
+            if (buffer.size() >= OUTPUT_FLUSH_BYTES) flush_output(out, buffer);
+        });
+        remove_runs(run_files);
+        if (merged != static_cast<long long>(stats.records)) {
+            cerr << "External sort lost records: " << merged << " of " << stats.records << endl;
+            return stats;
+        }
+    }
+    flush_output(out, buffer);
+    out.close();
+
+    if (stats.runs > 0) stats.merge_passes++;
+    stats.success = !out.fail();
+    return stats;
+}
+
+uint64_t csv_arr_delay_key(const string& line) {
+    const size_t ARR_DELAY_FIELD = 21;
+    size_t pos = 0;
+    for (size_t field = 0; field < ARR_DELAY_FIELD; ++field) {
+        pos = line.find(';', pos);
+        if (pos == string::npos) return orderedFloatKey(0.0f);
+        pos++;
+    }
+    // strtof останавливается на ';', пустое поле дает 0
+    return orderedFloatKey(strtof(line.c_str() + pos, nullptr));
+}
+
+ExternalSortStats external_sort_csv_by_arr_delay(const string& input_file, const string& output_file,
+                                                 const ExternalSortOptions& options) {
+    return external_sort_csv(input_file, output_file, csv_arr_delay_key, options);
+}
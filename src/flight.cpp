@@ -2,6 +2,8 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <charconv>
+#include <cmath>
 
 using namespace std;
 
@@ -115,12 +117,35 @@ bool flight::operator<(const flight& other) const {
 }
 
 std::string flight::get_unique_key() const {
-    stringstream ss;
-    ss << carrier_id << "_"
-        << fixed << setprecision(0) << flight_number << "_"
-        << year << "-"
-        << setw(2) << setfill('0') << month << "-"
-        << setw(2) << setfill('0') << month_day << "_"
-        << origin_code << "_" << dest_code;
-    return ss.str();
+    string key;
+    key.reserve(carrier_id.size() + origin_code.size() + dest_code.size() + 24);
+    append_unique_key(key);
+    return key;
+}
+
+static void append_number(string& out, long long value, int min_width = 0) {
+    char buf[24];
+    auto res = to_chars(buf, buf + sizeof(buf), value);
+    for (int len = static_cast<int>(res.ptr - buf); len < min_width; ++len) {
+        out += '0';
+    }
+    out.append(buf, res.ptr);
+}
+
+// Формат: CARRIER_NUMBER_YYYY-MM-DD_ORIGIN_DEST
+void flight::append_unique_key(std::string& out) const {
+    out += carrier_id;
+    out += '_';
+    // Номер округляется к ближайшему четному, как fixed << setprecision(0)
+    append_number(out, static_cast<long long>(nearbyint(flight_number)));
+    out += '_';
+    append_number(out, year);
+    out += '-';
+    append_number(out, month, 2);
+    out += '-';
+    append_number(out, month_day, 2);
+    out += '_';
+    out += origin_code;
+    out += '_';
+    out += dest_code;
 }
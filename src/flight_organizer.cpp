@@ -3,6 +3,8 @@
 #include <sstream>
 #include <iomanip>
 #include <iostream>
+#include <cmath>
+#include <csv2/writer.hpp>
 
 using namespace std;
 
@@ -29,10 +31,17 @@ void parse_unique_key(const string& key, string& carrier, string& flight_num,
 
 bool FlightOrganizer::add_flight(const flight& f) {
     auto result = unique_flights.insert(f);
+    if (result.second && !key_filter.empty()) {
+        add_key_hash(flight_key_hash(f));
+    }
+    // Узлы unordered_set не перемещаются при рехешировании, указатели индекса остаются верными
+    if (result.second && !time_index.empty()) {
+        time_index.add(*result.first);
+    }
     return result.second;
 }
 
-const unordered_set<flight>& FlightOrganizer::get_all_unique_flights() const {
+const FlightUnorderedSet& FlightOrganizer::get_all_unique_flights() const {
     return unique_flights;
 }
 
@@ -72,16 +81,38 @@ size_t FlightOrganizer::get_unique_flights_count() const {
     return unique_flights.size();
 }
 
-void FlightOrganizer::save_to_csv(const string& filename) const {
+static const char* CSV_HEADER = "unique_key,carrier,flight_num,year,month,day,origin,dest\n";
+
+static void append_csv_row(string& out, const flight& f) {
+    long long flight_num = static_cast<long long>(nearbyint(f.get_flight_number()));
+    f.append_unique_key(out);
+    out += ',';
+    out += f.get_carrier_id();
+    out += ',';
+    csv_append_int(out, flight_num);
+    out += ',';
+    csv_append_int(out, f.get_year());
+    out += ',';
+    csv_append_int(out, f.get_month());
+    out += ',';
+    csv_append_int(out, f.get_month_day());
+    out += ',';
+    out += f.get_origin_code();
+    out += ',';
+    out += f.get_dest_code();
+    out += '\n';
+}
+
+static void save_to_csv_stream(const FlightUnorderedSet& flights, const string& filename) {
     ofstream file(filename);
     if (!file.is_open()) {
         cerr << "Cannot open file: " << filename << endl;
         return;
     }
 
-    file << "unique_key,carrier,flight_num,year,month,day,origin,dest\n";
+    file << CSV_HEADER;
 
-    for (const auto& f : unique_flights) {
+    for (const auto& f : flights) {
         string key = f.get_unique_key();
         string carrier, flight_num, origin, dest;
         int year, month, day;
@@ -100,6 +131,51 @@ void FlightOrganizer::save_to_csv(const string& filename) const {
     file.close();
 }
 
+static void save_to_csv_csv2(const FlightUnorderedSet& flights, const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Cannot open file: " << filename << endl;
+        return;
+    }
+
+    csv2::Writer<csv2::delimiter<','>> writer(file);
+    writer.write_row(vector<string>{ "unique_key", "carrier", "flight_num", "year", "month", "day", "origin", "dest" });
+
+    vector<string> row(8);
+    for (const auto& f : flights) {
+        row[0].clear();
+        f.append_unique_key(row[0]);
+        row[1] = f.get_carrier_id();
+        row[2] = to_string(static_cast<long long>(nearbyint(f.get_flight_number())));
+        row[3] = to_string(f.get_year());
+        row[4] = to_string(f.get_month());
+        row[5] = to_string(f.get_month_day());
+        row[6] = f.get_origin_code();
+        row[7] = f.get_dest_code();
+        writer.write_row(row);
+    }
+}
+
+void FlightOrganizer::save_to_csv(const string& filename, CsvWriteMode mode, size_t threads) const {
+    if (mode == CsvWriteMode::Stream) {
+        save_to_csv_stream(unique_flights, filename);
+        return;
+    }
+    if (mode == CsvWriteMode::Csv2) {
+        save_to_csv_csv2(unique_flights, filename);
+        return;
+    }
+
+    vector<const flight*> records;
+    records.reserve(unique_flights.size());
+    for (const auto& f : unique_flights) {
+        records.push_back(&f);
+    }
+    if (!write_csv_buffered(filename, CSV_HEADER, records, append_csv_row, threads)) {
+        cerr << "Cannot open file: " << filename << endl;
+    }
+}
+
 void FlightOrganizer::organize_by_aircraft() {
     aircraft_to_flights.clear();
     for (const auto& f : unique_flights) {
@@ -108,6 +184,99 @@ void FlightOrganizer::organize_by_aircraft() {
     }
 }
 
+void FlightOrganizer::organize_by_time() {
+    time_index.build(unique_flights);
+}
+
+vector<const flight*> FlightOrganizer::get_flights_by_time_range(const string& origin,
+                                                                 const FlightDateTime& from,
+                                                                 const FlightDateTime& to) const {
+    return time_index.query(origin, from, to);
+}
+
+void FlightOrganizer::organize_bitmaps() {
+    bitmap_index.build(unique_flights);
+}
+
+void FlightOrganizer::organize_key_filter(double false_positive_rate) {
+    key_filter_rate = false_positive_rate;
+    build_key_filter(unique_flights.size() + vector_flights.size());
+}
+
+void FlightOrganizer::build_key_filter(size_t capacity) {
+    key_filter_capacity = capacity;
+    key_filter = BloomFilter(capacity, key_filter_rate);
+    for (const auto& f : unique_flights) {
+        key_filter.add(flight_key_hash(f));
+    }
+    // Остальные контейнеры add_flight_to_all содержат те же записи, что и vector_flights
+    for (const auto& f : vector_flights) {
+        key_filter.add(flight_key_hash(f));
+    }
+}
+
+void FlightOrganizer::add_key_hash(uint64_t key_hash) {
+    key_filter.add(key_hash);
+    // Сверх расчетного числа ключей доля ложных срабатываний растет - фильтр строится
+    // заново с двойным запасом, так что перестроения в сумме стоят O(1) на добавление
+    if (key_filter.get_items() > key_filter_capacity) {
+        build_key_filter(2 * key_filter.get_items());
+    }
+}
+
+bool FlightOrganizer::may_contain_key(const string& key) const {
+    return key_filter.empty() || key_filter.might_contain(flight_key_hash(key));
+}
+
+bool FlightOrganizer::contains(const flight& f) const {
+    return contains(f, key_filter.empty() ? 0 : flight_key_hash(f));
+}
+
+bool FlightOrganizer::contains(const flight& f, uint64_t key_hash) const {
+    if (!may_contain_key(key_hash)) {
+        return false;
+    }
+    return unique_flights.count(f) != 0;
+}
+
+const flight* FlightOrganizer::find_stored(FlightStorage storage, const string& key, uint64_t key_hash) const {
+    if (!may_contain_key(key_hash)) {
+        return nullptr;
+    }
+    switch (storage) {
+        case FlightStorage::Vector: return find_in_container(vector_flights, key);
+        case FlightStorage::UnorderedSet: return find_in_container(unordered_set_flights, key);
+        case FlightStorage::Set: return find_in_container(set_flights, key);
+        case FlightStorage::UnorderedMap: return find_in_container(unordered_map_flights, key);
+        case FlightStorage::Map: return find_in_container(map_flights, key);
+        case FlightStorage::UnorderedMultimap: {
+            auto it = unordered_multimap_flights.find(key);
+            return it == unordered_multimap_flights.end() ? nullptr : &it->second;
+        }
+        case FlightStorage::Multimap: {
+            auto it = multimap_flights.find(key);
+            return it == multimap_flights.end() ? nullptr : &it->second;
+        }
+    }
+    return nullptr;
+}
+
+vector<const flight*> FlightOrganizer::find_all_stored(FlightStorage storage, const string& key,
+                                                       uint64_t key_hash) const {
+    if (storage == FlightStorage::UnorderedMultimap || storage == FlightStorage::Multimap) {
+        if (!may_contain_key(key_hash)) {
+            return {};
+        }
+        return storage == FlightStorage::Multimap
+            ? find_in_multimap_container(multimap_flights, key)
+            : find_in_multimap_container(unordered_multimap_flights, key);
+    }
+    const flight* found = find_stored(storage, key, key_hash);
+    return found ? vector<const flight*>{ found } : vector<const flight*>{};
+}
+
+// Фильтр не очищается: ключи unique_flights в нем остаются, а лишние биты
+// дают только ложные срабатывания
 void FlightOrganizer::clear_all_structures() {
     vector_flights.clear();
     unordered_set_flights.clear();
@@ -126,4 +295,32 @@ void FlightOrganizer::add_flight_to_all(const flight& f) {
     add_to_container(map_flights, f);
     add_to_container(unordered_multimap_flights, f);
     add_to_container(multimap_flights, f);
+    // После вставки: перестроение фильтра обходит vector_flights и должно увидеть f
+    if (!key_filter.empty()) {
+        add_key_hash(flight_key_hash(f));
+    }
+}
+
+vector<ContainerMemory> FlightOrganizer::get_memory_usage() const {
+    size_t aircraft_records = 0;
+    size_t aircraft_bytes = sizeof(aircraft_to_flights) + aircraft_to_flights.get_allocator().allocated_bytes();
+    for (const auto& [key, list] : aircraft_to_flights) {
+        aircraft_records += list.size();
+        aircraft_bytes += heap_bytes(key) + list.capacity() * sizeof(flight*);
+    }
+
+    return {
+        { "unique_flights", unique_flights.size(), container_bytes(unique_flights) },
+        { "vector", vector_flights.size(), container_bytes(vector_flights) },
+        { "unordered_set", unordered_set_flights.size(), container_bytes(unordered_set_flights) },
+        { "set", set_flights.size(), container_bytes(set_flights) },
+        { "unordered_map", unordered_map_flights.size(), container_bytes(unordered_map_flights) },
+        { "map", map_flights.size(), container_bytes(map_flights) },
+        { "unordered_multimap", unordered_multimap_flights.size(), container_bytes(unordered_multimap_flights) },
+        { "multimap", multimap_flights.size(), container_bytes(multimap_flights) },
+        { "aircraft_to_flights", aircraft_records, aircraft_bytes },
+        { "time_index", time_index.size(), sizeof(time_index) + time_index.memory_bytes() },
+        { "bitmap_index", bitmap_index.size(), sizeof(bitmap_index) + bitmap_index.memory_bytes() },
+        { "key_filter", key_filter.get_items(), sizeof(key_filter) + key_filter.memory_bytes() },
+    };
 }
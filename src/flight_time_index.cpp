@@ -0,0 +1,169 @@
+#include "flight_time_index.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Порядок шкалы: время вылета, при равном времени - flight::operator<
+static bool time_order_less(int64_t a_key, const flight* a, int64_t b_key, const flight* b) {
+    if (a_key != b_key) return a_key < b_key;
+    return *a < *b;
+}
+
+int64_t FlightDateTime::to_key() const {
+    return static_cast<int64_t>(year) * 100000000LL
+        + static_cast<int64_t>(month) * 1000000LL
+        + static_cast<int64_t>(day) * 10000LL
+        + hhmm;
+}
+
+FlightDateTime FlightDateTime::of(const flight& f) {
+    return { f.get_year(), f.get_month(), f.get_month_day(), f.get_crs_dep_time() };
+}
+
+void FlightTimeIndex::build(const FlightUnorderedSet& flights) {
+    struct Entry {
+        int64_t key;
+        const flight* f;
+    };
+    unordered_map<string, vector<Entry>> entries;
+
+    for (const auto& f : flights) {
+        entries[f.get_origin_code()].push_back({ FlightDateTime::of(f).to_key(), &f });
+    }
+
+    by_origin.clear();
+    by_origin.reserve(entries.size());
+    for (auto& [origin, list] : entries) {
+        // При равном времени порядок задает flight::operator<, чтобы результат не зависел от хеш-таблицы
+        sort(list.begin(), list.end(), [](const Entry& a, const Entry& b) {
+            return time_order_less(a.key, a.f, b.key, b.f);
+        });
+
+        Timeline& timeline = by_origin[origin];
+        timeline.keys.reserve(list.size());
+        timeline.flights.reserve(list.size());
+        for (const auto& e : list) {
+            timeline.keys.push_back(e.key);
+            timeline.flights.push_back(e.f);
+        }
+    }
+}
+
+void FlightTimeIndex::add(const flight& f) {
+    Timeline& timeline = by_origin[f.get_origin_code()];
+    int64_t key = FlightDateTime::of(f).to_key();
+
+    auto first = lower_bound(timeline.pending_keys.begin(), timeline.pending_keys.end(), key);
+    auto last = upper_bound(first, timeline.pending_keys.end(), key);
+    size_t pos = first - timeline.pending_keys.begin();
+    size_t end_pos = last - timeline.pending_keys.begin();
+    while (pos < end_pos && *timeline.pending_flights[pos] < f) pos++;
+
+    timeline.pending_keys.insert(timeline.pending_keys.begin() + pos, key);
+    timeline.pending_flights.insert(timeline.pending_flights.begin() + pos, &f);
+
+    // Буфер длиной ~sqrt(n): вставка в него и редкие слияния стоят O(sqrt n) на запись
+    size_t limit = max<size_t>(32, static_cast<size_t>(sqrt(static_cast<double>(timeline.keys.size()))));
+    if (timeline.pending_keys.size() > limit) {
+        merge_pending(timeline);
+    }
+}
+
+void FlightTimeIndex::merge_pending(Timeline& timeline) {
+    // Слияние с конца на месте: шкала расширяется, элементы раскладываются справа налево
+    size_t i = timeline.keys.size();
+    size_t j = timeline.pending_keys.size();
+    size_t out = i + j;
+    timeline.keys.resize(out);
+    timeline.flights.resize(out);
+    while (j > 0) {
+        if (i > 0 && time_order_less(timeline.pending_keys[j - 1], timeline.pending_flights[j - 1],
+                                     timeline.keys[i - 1], timeline.flights[i - 1])) {
+            --i;
+            --out;
+            timeline.keys[out] = timeline.keys[i];
+            timeline.flights[out] = timeline.flights[i];
+        } else {
+            --j;
+            --out;
+            timeline.keys[out] = timeline.pending_keys[j];
+            timeline.flights[out] = timeline.pending_flights[j];
+        }
+    }
+    timeline.pending_keys.clear();
+    timeline.pending_flights.clear();
+}
+
+void FlightTimeIndex::clear() {
+    by_origin.clear();
+}
+
+const FlightTimeIndex::Timeline* FlightTimeIndex::find_timeline(const string& origin) const {
+    auto it = by_origin.find(origin);
+    return it == by_origin.end() ? nullptr : &it->second;
+}
+
+vector<const flight*> FlightTimeIndex::query(const string& origin,
+                                             const FlightDateTime& from, const FlightDateTime& to) const {
+    vector<const flight*> result;
+    const Timeline* timeline = find_timeline(origin);
+    if (timeline == nullptr) {
+        return result;
+    }
+
+    auto first = lower_bound(timeline->keys.begin(), timeline->keys.end(), from.to_key());
+    auto last = upper_bound(first, timeline->keys.end(), to.to_key());
+    size_t i = first - timeline->keys.begin();
+    size_t end_i = last - timeline->keys.begin();
+
+    auto pending_first = lower_bound(timeline->pending_keys.begin(), timeline->pending_keys.end(), from.to_key());
+    auto pending_last = upper_bound(pending_first, timeline->pending_keys.end(), to.to_key());
+    size_t j = pending_first - timeline->pending_keys.begin();
+    size_t end_j = pending_last - timeline->pending_keys.begin();
+
+    result.reserve(end_i - i + end_j - j);
+    while (i < end_i && j < end_j) {
+        if (time_order_less(timeline->pending_keys[j], timeline->pending_flights[j],
+                            timeline->keys[i], timeline->flights[i])) {
+            result.push_back(timeline->pending_flights[j++]);
+        } else {
+            result.push_back(timeline->flights[i++]);
+        }
+    }
+    result.insert(result.end(), timeline->flights.begin() + i, timeline->flights.begin() + end_i);
+    result.insert(result.end(), timeline->pending_flights.begin() + j, timeline->pending_flights.begin() + end_j);
+    return result;
+}
+
+size_t FlightTimeIndex::count(const string& origin, const FlightDateTime& from, const FlightDateTime& to) const {
+    const Timeline* timeline = find_timeline(origin);
+    if (timeline == nullptr) {
+        return 0;
+    }
+    auto first = lower_bound(timeline->keys.begin(), timeline->keys.end(), from.to_key());
+    auto last = upper_bound(first, timeline->keys.end(), to.to_key());
+    auto pending_first = lower_bound(timeline->pending_keys.begin(), timeline->pending_keys.end(), from.to_key());
+    auto pending_last = upper_bound(pending_first, timeline->pending_keys.end(), to.to_key());
+    return (last - first) + (pending_last - pending_first);
+}
+
+size_t FlightTimeIndex::size() const {
+    size_t total = 0;
+    for (const auto& entry : by_origin) {
+        total += entry.second.flights.size() + entry.second.pending_flights.size();
+    }
+    return total;
+}
+
+size_t FlightTimeIndex::memory_bytes() const {
+    size_t bytes = by_origin.get_allocator().allocated_bytes();
+    for (const auto& [origin, timeline] : by_origin) {
+        bytes += heap_bytes(origin)
+            + timeline.keys.capacity() * sizeof(int64_t)
+            + timeline.flights.capacity() * sizeof(const flight*)
+            + timeline.pending_keys.capacity() * sizeof(int64_t)
+            + timeline.pending_flights.capacity() * sizeof(const flight*);
+    }
+    return bytes;
+}
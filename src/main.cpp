@@ -5,18 +5,30 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <limits>
 #include <cstring>
 #include <cstdio>
+#include <thread>
+#include <atomic>
+#include <functional>
 
 #include "flight.h"
 #include "flight_organizer.h"
+#include "flight_containers.h"
 #include "reading_by_instances.h"
 #include "compression.h"
 #include "sorting.h"
 #include "Search_Algs.h"
 #include "graph.h"
+#include "concurrent_flight_organizer.h"
+#include "thread_pool.h"
+#include "top_k.h"
+#include "column_scan.h"
+#include "external_sort.h"
+#include "sorted_flight_view.h"
+#include "place_index.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -78,13 +90,14 @@ void compare_storage_types(const vector<flight> &all_flights) {
         string name;
         double insert_time;
         double search_time;
-        size_t memory_estimate;
+        size_t memory_bytes;
+        size_t records;
     };
     vector<StorageResult> results;
 
     // 1. Vector
     cout << "1. std::vector<flight>" << endl; {
-        vector<flight> container;
+        FlightVector container;
         auto start = steady_clock::now();
         for (const auto &f: test_data) {
             container.push_back(f);
@@ -99,17 +112,18 @@ void compare_storage_types(const vector<flight> &all_flights) {
         end = steady_clock::now();
         double search_time = duration_cast<microseconds>(end - start).count() / 1000000.0;
 
-        size_t mem = container.capacity() * sizeof(flight);
-        results.push_back({"vector", insert_time, search_time, mem});
+        size_t mem = container_bytes(container);
+        results.push_back({"vector", insert_time, search_time, mem, container.size()});
 
         cout << "  Время вставки: " << fixed << setprecision(3) << insert_time << " сек" << endl;
         cout << "  Время поиска: " << fixed << setprecision(6) << search_time << " сек" << endl;
-        cout << "  Память: ~" << format_bytes(mem) << endl;
+        cout << "  Память: " << format_bytes(mem)
+                << " (" << mem / max<size_t>(container.size(), 1) << " байт на запись)" << endl;
     }
 
     // 2. Unordered_set
     cout << "\n2. std::unordered_set<flight>" << endl; {
-        unordered_set<flight> container;
+        FlightUnorderedSet container;
         auto start = steady_clock::now();
         for (const auto &f: test_data) {
             container.insert(f);
@@ -123,17 +137,18 @@ void compare_storage_types(const vector<flight> &all_flights) {
         end = steady_clock::now();
         double search_time = duration_cast<microseconds>(end - start).count() / 1000000.0;
 
-        size_t mem = container.size() * sizeof(flight) + container.bucket_count() * sizeof(void *);
-        results.push_back({"unordered_set", insert_time, search_time, mem});
+        size_t mem = container_bytes(container);
+        results.push_back({"unordered_set", insert_time, search_time, mem, container.size()});
 
         cout << "  Время вставки: " << fixed << setprecision(3) << insert_time << " сек" << endl;
         cout << "  Время поиска: " << fixed << setprecision(6) << search_time << " сек" << endl;
-        cout << "  Память: ~" << format_bytes(mem) << endl;
+        cout << "  Память: " << format_bytes(mem)
+                << " (" << mem / max<size_t>(container.size(), 1) << " байт на запись)" << endl;
     }
 
     // 3. Set
     cout << "\n3. std::set<flight>" << endl; {
-        set<flight> container;
+        FlightSet container;
         auto start = steady_clock::now();
         for (const auto &f: test_data) {
             container.insert(f);
@@ -147,17 +162,18 @@ void compare_storage_types(const vector<flight> &all_flights) {
         end = steady_clock::now();
         double search_time = duration_cast<microseconds>(end - start).count() / 1000000.0;
 
-        size_t mem = container.size() * (sizeof(flight) + sizeof(void *));
-        results.push_back({"set", insert_time, search_time, mem});
+        size_t mem = container_bytes(container);
+        results.push_back({"set", insert_time, search_time, mem, container.size()});
 
         cout << "  Время вставки: " << fixed << setprecision(3) << insert_time << " сек" << endl;
         cout << "  Время поиска: " << fixed << setprecision(6) << search_time << " сек" << endl;
-        cout << "  Память: ~" << format_bytes(mem) << endl;
+        cout << "  Память: " << format_bytes(mem)
+                << " (" << mem / max<size_t>(container.size(), 1) << " байт на запись)" << endl;
     }
 
     // 4. Unordered_map
     cout << "\n4. std::unordered_map<string, flight>" << endl; {
-        unordered_map<string, flight> container;
+        FlightUnorderedMap container;
         auto start = steady_clock::now();
         for (const auto &f: test_data) {
             container[f.get_unique_key()] = f;
@@ -171,17 +187,18 @@ void compare_storage_types(const vector<flight> &all_flights) {
         end = steady_clock::now();
         double search_time = duration_cast<microseconds>(end - start).count() / 1000000.0;
 
-        size_t mem = container.size() * (sizeof(string) + sizeof(flight)) + container.bucket_count() * sizeof(void *);
-        results.push_back({"unordered_map", insert_time, search_time, mem});
+        size_t mem = container_bytes(container);
+        results.push_back({"unordered_map", insert_time, search_time, mem, container.size()});
 
         cout << "  Время вставки: " << fixed << setprecision(3) << insert_time << " сек" << endl;
         cout << "  Время поиска: " << fixed << setprecision(6) << search_time << " сек" << endl;
-        cout << "  Память: ~" << format_bytes(mem) << endl;
+        cout << "  Память: " << format_bytes(mem)
+                << " (" << mem / max<size_t>(container.size(), 1) << " байт на запись)" << endl;
     }
 
     // 5. Map
     cout << "\n5. std::map<string, flight>" << endl; {
-        map<string, flight> container;
+        FlightMap container;
         auto start = steady_clock::now();
         for (const auto &f: test_data) {
             container[f.get_unique_key()] = f;
@@ -195,17 +212,18 @@ void compare_storage_types(const vector<flight> &all_flights) {
         end = steady_clock::now();
         double search_time = duration_cast<microseconds>(end - start).count() / 1000000.0;
 
-        size_t mem = container.size() * (sizeof(string) + sizeof(flight) + 3 * sizeof(void *));
-        results.push_back({"map", insert_time, search_time, mem});
+        size_t mem = container_bytes(container);
+        results.push_back({"map", insert_time, search_time, mem, container.size()});
 
         cout << "  Время вставки: " << fixed << setprecision(3) << insert_time << " сек" << endl;
         cout << "  Время поиска: " << fixed << setprecision(6) << search_time << " сек" << endl;
-        cout << "  Память: ~" << format_bytes(mem) << endl;
+        cout << "  Память: " << format_bytes(mem)
+                << " (" << mem / max<size_t>(container.size(), 1) << " байт на запись)" << endl;
     }
 
     // 6. Unordered_multimap
     cout << "\n6. std::unordered_multimap<string, flight>" << endl; {
-        unordered_multimap<string, flight> container;
+        FlightUnorderedMultimap container;
         auto start = steady_clock::now();
         for (const auto &f: test_data) {
             container.insert({f.get_unique_key(), f});
@@ -219,17 +237,18 @@ void compare_storage_types(const vector<flight> &all_flights) {
         end = steady_clock::now();
         double search_time = duration_cast<microseconds>(end - start).count() / 1000000.0;
 
-        size_t mem = container.size() * (sizeof(string) + sizeof(flight)) + container.bucket_count() * sizeof(void *);
-        results.push_back({"unordered_multimap", insert_time, search_time, mem});
+        size_t mem = container_bytes(container);
+        results.push_back({"unordered_multimap", insert_time, search_time, mem, container.size()});
 
         cout << "  Время вставки: " << fixed << setprecision(3) << insert_time << " сек" << endl;
         cout << "  Время поиска: " << fixed << setprecision(6) << search_time << " сек" << endl;
-        cout << "  Память: ~" << format_bytes(mem) << endl;
+        cout << "  Память: " << format_bytes(mem)
+                << " (" << mem / max<size_t>(container.size(), 1) << " байт на запись)" << endl;
     }
 
     // 7. Multimap
     cout << "\n7. std::multimap<string, flight>" << endl; {
-        multimap<string, flight> container;
+        FlightMultimap container;
         auto start = steady_clock::now();
         for (const auto &f: test_data) {
             container.insert({f.get_unique_key(), f});
@@ -243,12 +262,13 @@ void compare_storage_types(const vector<flight> &all_flights) {
         end = steady_clock::now();
         double search_time = duration_cast<microseconds>(end - start).count() / 1000000.0;
 
-        size_t mem = container.size() * (sizeof(string) + sizeof(flight) + 3 * sizeof(void *));
-        results.push_back({"multimap", insert_time, search_time, mem});
+        size_t mem = container_bytes(container);
+        results.push_back({"multimap", insert_time, search_time, mem, container.size()});
 
         cout << "  Время вставки: " << fixed << setprecision(3) << insert_time << " сек" << endl;
         cout << "  Время поиска: " << fixed << setprecision(6) << search_time << " сек" << endl;
-        cout << "  Память: ~" << format_bytes(mem) << endl;
+        cout << "  Память: " << format_bytes(mem)
+                << " (" << mem / max<size_t>(container.size(), 1) << " байт на запись)" << endl;
     }
 
     // Сравнительная таблица
@@ -256,14 +276,315 @@ void compare_storage_types(const vector<flight> &all_flights) {
     cout << "\t" << left << "Контейнер"
             << "\t" << "Вставка (сек)"
             << "\t" << "Поиск (сек)"
-            << "\t" << "Память" << endl;
-    cout << string(73, '-') << endl;
+            << "\t" << "Память"
+            << "\t" << "Байт/запись" << endl;
+    cout << string(85, '-') << endl;
 
     for (const auto &r: results) {
         cout << setw(22) << left << r.name
                 << setw(18) << fixed << setprecision(3) << r.insert_time
                 << setw(18) << setprecision(6) << r.search_time
-                << format_bytes(r.memory_estimate) << endl;
+                << setw(12) << format_bytes(r.memory_bytes)
+                << r.memory_bytes / max<size_t>(r.records, 1) << endl;
+    }
+}
+
+void report_organizer_memory(const vector<flight> &test_data) {
+    cout << "\n=== ПАМЯТЬ КОНТЕЙНЕРОВ И ИНДЕКСОВ FlightOrganizer ===" << endl;
+
+    // Семь контейнеров add_flight_to_all хранят по копии каждой записи, поэтому выборка ограничена
+    const size_t RECORDS = min<size_t>(test_data.size(), 200000);
+    FlightOrganizer organizer;
+    for (size_t i = 0; i < RECORDS; ++i) {
+        organizer.add_flight(test_data[i]);
+        organizer.add_flight_to_all(test_data[i]);
+    }
+    organizer.organize_by_aircraft();
+    organizer.organize_by_time();
+    organizer.organize_bitmaps();
+    organizer.organize_key_filter();
+    cout << "Записей: " << RECORDS << ", уникальных: " << organizer.get_unique_flights_count() << endl;
+
+    cout << "\t" << left << "Контейнер"
+            << "\t" << "Записей"
+            << "\t" << "Память"
+            << "\t" << "Байт/запись" << endl;
+    cout << string(70, '-') << endl;
+
+    size_t total = 0;
+    for (const auto &m: organizer.get_memory_usage()) {
+        total += m.bytes;
+        cout << setw(22) << left << m.name
+                << setw(12) << m.records
+                << setw(12) << format_bytes(m.bytes)
+                << m.bytes / max<size_t>(m.records, 1) << endl;
+    }
+    cout << "Всего: " << format_bytes(total) << endl;
+}
+
+void compare_key_filter(const vector<flight> &test_data) {
+    cout << "\n=== ФИЛЬТР БЛУМА ПЕРЕД ПОИСКОМ ПО КЛЮЧУ ===" << endl;
+
+    // В организатор попадает первая половина выборки, запросы - вторая (почти все промахи)
+    size_t half = test_data.size() / 2;
+    FlightOrganizer organizer;
+    for (size_t i = 0; i < half; ++i) {
+        organizer.add_flight(test_data[i]);
+    }
+    vector<flight> queries(test_data.begin() + half, test_data.end());
+    vector<string> query_keys;
+    vector<uint64_t> query_hashes;
+    query_keys.reserve(queries.size());
+    query_hashes.reserve(queries.size());
+    for (const auto &f: queries) {
+        query_keys.push_back(f.get_unique_key());
+        query_hashes.push_back(flight_key_hash(query_keys.back()));
+    }
+    cout << "Уникальных рейсов в организаторе: " << organizer.get_unique_flights_count()
+            << ", запросов: " << queries.size() << endl;
+
+    auto measure_contains = [&](const string &name) {
+        size_t found = 0;
+        auto start = steady_clock::now();
+        for (const auto &f: queries) {
+            found += organizer.contains(f) ? 1 : 0;
+        }
+        auto end = steady_clock::now();
+        double ns = duration<double, nano>(end - start).count() / max<size_t>(queries.size(), 1);
+        cout << "  " << setw(10) << right << fixed << setprecision(1) << ns << left
+                << " нс/запрос  contains(flight) " << name << " (найдено: " << found << ")" << endl;
+    };
+
+    measure_contains("без фильтра");
+    size_t expected_found = 0;
+    for (const auto &f: queries) {
+        expected_found += organizer.contains(f) ? 1 : 0;
+    }
+
+    cout << "\nДоля ложных срабатываний и память:" << endl;
+    for (double rate: {0.1, 0.01, 0.001}) {
+        organizer.organize_key_filter(rate);
+        const BloomFilter &filter = organizer.get_key_filter();
+        size_t passed = 0;
+        auto start = steady_clock::now();
+        for (const auto &key: query_keys) {
+            passed += organizer.may_contain_key(key) ? 1 : 0;
+        }
+        auto end = steady_clock::now();
+        double ns = duration<double, nano>(end - start).count() / max<size_t>(query_keys.size(), 1);
+
+        size_t passed_by_hash = 0;
+        start = steady_clock::now();
+        for (uint64_t hash: query_hashes) {
+            passed_by_hash += organizer.may_contain_key(hash) ? 1 : 0;
+        }
+        end = steady_clock::now();
+        double hash_ns = duration<double, nano>(end - start).count() / max<size_t>(query_hashes.size(), 1);
+        if (passed_by_hash != passed) cout << "  ОШИБКА: проверки по строке и по хешу расходятся" << endl;
+
+        size_t misses = query_keys.size() - expected_found;
+        double measured = misses > 0 ? static_cast<double>(passed - expected_found) / misses : 0.0;
+        cout << "  заданная " << setprecision(3) << rate
+                << ": измеренная " << setprecision(4) << measured
+                << ", хешей " << filter.get_hash_count()
+                << ", " << format_bytes(filter.memory_bytes())
+                << " (" << setprecision(1) << 8.0 * filter.memory_bytes() / max<size_t>(filter.get_items(), 1)
+                << " бит на ключ), " << ns << " нс/проверку строки ключа, "
+                << hash_ns << " нс/проверку готового хеша" << endl;
+    }
+
+    // Фильтр строится по 10% записей, остальные 90% добавляются после построения
+    FlightOrganizer growing;
+    for (size_t i = 0; i < half / 10; ++i) {
+        growing.add_flight(test_data[i]);
+    }
+    growing.organize_key_filter(0.01);
+    for (size_t i = half / 10; i < half; ++i) {
+        growing.add_flight(test_data[i]);
+    }
+    size_t grown_passed = 0;
+    for (uint64_t hash: query_hashes) {
+        grown_passed += growing.may_contain_key(hash) ? 1 : 0;
+    }
+    size_t grown_misses = query_hashes.size() - expected_found;
+    cout << "  заданная 0.01 после роста с " << half / 10 << " до " << growing.get_key_filter().get_items()
+            << " ключей: измеренная " << setprecision(4)
+            << (grown_misses > 0 ? static_cast<double>(grown_passed - expected_found) / grown_misses : 0.0)
+            << ", " << format_bytes(growing.get_key_filter().memory_bytes()) << endl;
+
+    organizer.organize_key_filter(0.01);
+    cout << endl;
+    measure_contains("с фильтром (0.01)");
+
+    size_t found_by_hash = 0;
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i) {
+        found_by_hash += organizer.contains(queries[i], query_hashes[i]) ? 1 : 0;
+    }
+    auto end = steady_clock::now();
+    cout << "  " << setw(10) << right << fixed << setprecision(1)
+            << duration<double, nano>(end - start).count() / max<size_t>(queries.size(), 1) << left
+            << " нс/запрос  contains(flight, hash) с фильтром (0.01) (найдено: " << found_by_hash << ")" << endl;
+
+    // Поиск отсутствующего ключа в векторе - полный обход без фильтра
+    const size_t VECTOR_RECORDS = min<size_t>(half, 100000);
+    const size_t VECTOR_QUERIES = min<size_t>(query_keys.size(), 50);
+    FlightOrganizer vector_organizer;
+    for (size_t i = 0; i < VECTOR_RECORDS; ++i) {
+        vector_organizer.add_flight_to_all(test_data[i]);
+    }
+    auto measure_vector = [&](const string &name) {
+        size_t found = 0;
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < VECTOR_QUERIES; ++i) {
+            found += vector_organizer.find_stored(FlightStorage::Vector, query_keys[i], query_hashes[i]) ? 1 : 0;
+        }
+        auto end = steady_clock::now();
+        double us = duration<double, micro>(end - start).count() / max<size_t>(VECTOR_QUERIES, 1);
+        cout << "  " << setw(10) << right << fixed << setprecision(2) << us << left
+                << " мкс/запрос  find_stored(Vector, " << VECTOR_RECORDS << " записей) " << name
+                << " (найдено: " << found << ")" << endl;
+    };
+    measure_vector("без фильтра");
+    vector_organizer.organize_key_filter(0.01);
+    measure_vector("с фильтром (0.01)");
+}
+
+void compare_time_index(const vector<flight> &test_data) {
+    cout << "\n=== ИНДЕКС ПО ВРЕМЕНИ ВЫЛЕТА ===" << endl;
+
+    // Индекс строится по 90% выборки, остальное добавляется после построения через add_flight
+    size_t built_part = test_data.size() - test_data.size() / 10;
+    FlightOrganizer organizer;
+    for (size_t i = 0; i < built_part; ++i) {
+        organizer.add_flight(test_data[i]);
+    }
+    auto build_start = steady_clock::now();
+    organizer.organize_by_time();
+    auto build_end = steady_clock::now();
+    auto add_start = steady_clock::now();
+    for (size_t i = built_part; i < test_data.size(); ++i) {
+        organizer.add_flight(test_data[i]);
+    }
+    auto add_end = steady_clock::now();
+    cout << "Построение: " << fixed << setprecision(2)
+            << duration<double, milli>(build_end - build_start).count() << " мс, дозапись "
+            << test_data.size() - built_part << " записей: "
+            << duration<double, milli>(add_end - add_start).count() << " мс" << endl;
+
+    const string origin = "ORD";
+    const FlightDateTime from{2024, 7, 1, 600};
+    const FlightDateTime to{2024, 7, 1, 1200};
+    cout << "Запрос: " << origin << ", 2024-07-01 06:00-12:00" << endl;
+
+    const int REPEATS = 100;
+    vector<const flight *> indexed;
+    auto start = steady_clock::now();
+    for (int r = 0; r < REPEATS; ++r) {
+        indexed = organizer.get_flights_by_time_range(origin, from, to);
+    }
+    auto end = steady_clock::now();
+    double index_us = duration<double, micro>(end - start).count() / REPEATS;
+
+    vector<const flight *> scanned;
+    start = steady_clock::now();
+    for (const auto &f: organizer.get_all_unique_flights()) {
+        int64_t key = FlightDateTime::of(f).to_key();
+        if (f.get_origin_code() == origin && key >= from.to_key() && key <= to.to_key()) {
+            scanned.push_back(&f);
+        }
+    }
+    end = steady_clock::now();
+    double scan_us = duration<double, micro>(end - start).count();
+
+    vector<const flight *> sorted_indexed(indexed), sorted_scanned(scanned);
+    sort(sorted_indexed.begin(), sorted_indexed.end());
+    sort(sorted_scanned.begin(), sorted_scanned.end());
+    bool ordered = is_sorted(indexed.begin(), indexed.end(), [](const flight *a, const flight *b) {
+        return FlightDateTime::of(*a).to_key() < FlightDateTime::of(*b).to_key();
+    });
+
+    cout << "  Индекс:            " << setw(6) << indexed.size() << " рейсов, "
+            << fixed << setprecision(2) << index_us << " мкс" << endl;
+    cout << "  Линейный фильтр:   " << setw(6) << scanned.size() << " рейсов, "
+            << scan_us << " мкс" << endl;
+    cout << "  Результаты совпадают: " << (sorted_indexed == sorted_scanned && ordered ? "да" : "НЕТ") << endl;
+}
+
+void compare_bitmap_index(const vector<flight> &test_data) {
+    cout << "\n=== БИТОВЫЕ ИНДЕКСЫ (ROARING) ===" << endl;
+
+    FlightOrganizer organizer;
+    for (const auto &f: test_data) {
+        organizer.add_flight(f);
+    }
+    auto build_start = steady_clock::now();
+    organizer.organize_bitmaps();
+    auto build_end = steady_clock::now();
+    const FlightBitmapIndex &index = organizer.get_bitmap_index();
+    cout << "Строк: " << index.size() << ", построение: " << fixed << setprecision(2)
+            << duration<double, milli>(build_end - build_start).count() << " мс, память: "
+            << format_bytes(index.memory_bytes()) << endl;
+
+    struct BitmapQuery {
+        string name;
+        function<RoaringBitmap()> by_bitmaps;
+        function<bool(const flight &)> by_scan;
+    };
+    vector<BitmapQuery> queries = {
+        {
+            "canceled AND weather_delay AND month == 1",
+            [&] {
+                return index.by_flag(FlightFlag::Canceled) & index.by_flag(FlightFlag::WeatherDelay)
+                       & index.by_month(1);
+            },
+            [](const flight &f) { return f.is_canceled() && f.hasWeatherDelay() && f.get_month() == 1; }
+        },
+        {
+            "(canceled OR diverted) AND NOT month == 12",
+            [&] {
+                return (index.by_flag(FlightFlag::Canceled) | index.by_flag(FlightFlag::Diverted))
+                        .and_not(index.by_month(12));
+            },
+            [](const flight &f) { return (f.is_canceled() || f.is_diverted()) && f.get_month() != 12; }
+        },
+        {
+            "NOT (late_aircraft OR carrier) AND week_day == 5",
+            [&] {
+                return index.negate(index.by_flag(FlightFlag::LateAircraftDelay)
+                                    | index.by_flag(FlightFlag::CarrierDelay)) & index.by_week_day(5);
+            },
+            [](const flight &f) {
+                return !(f.hasLateAircraftDelay() || f.hasCarrierDelay()) && f.get_week_day() == 5;
+            }
+        },
+    };
+
+    const int REPEATS = 20;
+    for (const auto &q: queries) {
+        RoaringBitmap result;
+        auto start = steady_clock::now();
+        for (int r = 0; r < REPEATS; ++r) {
+            result = q.by_bitmaps();
+        }
+        auto end = steady_clock::now();
+        double bitmap_ms = duration<double, milli>(end - start).count() / REPEATS;
+
+        vector<const flight *> scanned;
+        start = steady_clock::now();
+        for (const auto &f: organizer.get_all_unique_flights()) {
+            if (q.by_scan(f)) scanned.push_back(&f);
+        }
+        end = steady_clock::now();
+        double scan_ms = duration<double, milli>(end - start).count();
+
+        vector<const flight *> found = index.get_flights(result);
+        sort(found.begin(), found.end());
+        sort(scanned.begin(), scanned.end());
+        cout << "  " << q.name << endl;
+        cout << "    найдено: " << result.cardinality() << ", битмапы: " << fixed << setprecision(3)
+                << bitmap_ms << " мс, полный обход: " << scan_ms << " мс, совпадает: "
+                << (found == scanned ? "да" : "НЕТ") << endl;
     }
 }
 
@@ -376,8 +697,8 @@ void compare_sorting_algorithms(const vector<flight> &test_data) {
     };
     vector<SortResult> results;
 
-    // 1. mergeSortByArrivalDelay - рекурсивная merge sort
-    cout << "1. mergeSortByArrivalDelay (рекурсивная Merge Sort)" << endl; {
+    // 1. mergeSortByArrivalDelay - восходящая merge sort с одним буфером
+    cout << "1. mergeSortByArrivalDelay (Merge Sort, один буфер + вставки)" << endl; {
         vector<flight> data_copy = test_data;
         auto start = steady_clock::now();
         mergeSortByArrivalDelay(data_copy);
@@ -417,6 +738,142 @@ void compare_sorting_algorithms(const vector<flight> &test_data) {
         cout << endl;
     }
 
+    // 3. Перестановка по задержке: сортируются только ключи и индексы
+    cout << "\n3. sortPermutationByArrivalDelay (индексы + apply_permutation)" << endl; {
+        vector<flight> data_copy = test_data;
+        auto start = steady_clock::now();
+        auto perm = sortPermutationByArrivalDelay(data_copy);
+        auto perm_end = steady_clock::now();
+        apply_permutation(data_copy, perm);
+        auto end = steady_clock::now();
+        double perm_time = duration_cast<milliseconds>(perm_end - start).count() / 1000.0;
+        double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+        results.push_back({"sortPermutationByArrivalDelay", elapsed, true});
+        cout << "  Время: " << fixed << setprecision(3) << elapsed
+                << " сек (перестановка: " << perm_time << " сек)" << endl;
+
+        cout << "  Рейсы:\n";
+        for (size_t i = 0; i < min(static_cast<size_t>(3), data_copy.size()); ++i) {
+            if (i > 0) cout << ", ";
+            cout << data_copy[i].get_arr_delay() << " мин"
+                    << ", рейс:" << data_copy[i].get_unique_key();
+        }
+        cout << endl;
+    }
+
+    // 4. Перестановка со специальным порядком
+    cout << "\n4. specialFlightSortPermutation (индексы + apply_permutation)" << endl; {
+        vector<flight> data_copy = test_data;
+        auto start = steady_clock::now();
+        auto perm = specialFlightSortPermutation(data_copy);
+        auto perm_end = steady_clock::now();
+        apply_permutation(data_copy, perm);
+        auto end = steady_clock::now();
+        double perm_time = duration_cast<milliseconds>(perm_end - start).count() / 1000.0;
+        double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+        results.push_back({"specialFlightSortPermutation", elapsed, true});
+        cout << "  Время: " << fixed << setprecision(3) << elapsed
+                << " сек (перестановка: " << perm_time << " сек)" << endl;
+
+        cout << "  Рейсы:\n";
+        for (size_t i = 0; i < min(static_cast<size_t>(3), data_copy.size()); ++i) {
+            if (i > 0) cout << ", ";
+            cout << "отм:" << (data_copy[i].is_canceled() ? "да" : "нет")
+                    << " зад:" << data_copy[i].get_arr_delay() << "мин"
+                    << ", рейс:" << data_copy[i].get_unique_key();
+        }
+        cout << endl;
+    }
+
+    // 5. Поразрядная сортировка по задержке
+    cout << "\n5. radixSortByArrivalDelay (LSD radix, O(n))" << endl; {
+        vector<flight> data_copy = test_data;
+        auto start = steady_clock::now();
+        radixSortByArrivalDelay(data_copy);
+        auto end = steady_clock::now();
+        double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+        results.push_back({"radixSortByArrivalDelay", elapsed, true});
+        cout << "  Время: " << fixed << setprecision(3) << elapsed << " сек" << endl;
+
+        cout << "  Рейсы:\n";
+        for (size_t i = 0; i < min(static_cast<size_t>(3), data_copy.size()); ++i) {
+            if (i > 0) cout << ", ";
+            cout << data_copy[i].get_arr_delay() << " мин"
+                    << ", рейс:" << data_copy[i].get_unique_key();
+        }
+        cout << endl;
+    }
+
+    // 6. Поразрядная сортировка по составному 64-битному ключу
+    cout << "\n6. radixSpecialFlightSort (LSD radix, ключ: отмена + штат + задержка)" << endl; {
+        vector<flight> data_copy = test_data;
+        auto start = steady_clock::now();
+        radixSpecialFlightSort(data_copy);
+        auto end = steady_clock::now();
+        double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+        results.push_back({"radixSpecialFlightSort", elapsed, true});
+        cout << "  Время: " << fixed << setprecision(3) << elapsed << " сек" << endl;
+
+        cout << "  Рейсы:\n";
+        for (size_t i = 0; i < min(static_cast<size_t>(3), data_copy.size()); ++i) {
+            if (i > 0) cout << ", ";
+            cout << "отм:" << (data_copy[i].is_canceled() ? "да" : "нет")
+                    << " зад:" << data_copy[i].get_arr_delay() << "мин"
+                    << ", рейс:" << data_copy[i].get_unique_key();
+        }
+        cout << endl;
+    }
+
+    // 7. Параллельная merge sort
+    cout << "\n7. parallelMergeSortByArrivalDelay (Merge Sort в пуле из "
+            << ThreadPool::shared().size() << " потоков)" << endl; {
+        vector<flight> data_copy = test_data;
+        auto start = steady_clock::now();
+        parallelMergeSortByArrivalDelay(data_copy);
+        auto end = steady_clock::now();
+        double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+        results.push_back({"parallelMergeSortByArrivalDelay", elapsed, true});
+        cout << "  Время: " << fixed << setprecision(3) << elapsed << " сек" << endl;
+
+        cout << "  Рейсы:\n";
+        for (size_t i = 0; i < min(static_cast<size_t>(3), data_copy.size()); ++i) {
+            if (i > 0) cout << ", ";
+            cout << data_copy[i].get_arr_delay() << " мин"
+                    << ", рейс:" << data_copy[i].get_unique_key();
+        }
+        cout << endl;
+    }
+
+    // 8. Decorate-sort-undecorate со специальным порядком (против std::sort из п. 2)
+    cout << "\n8. decoratedSpecialFlightSort (ключи один раз + префиксы строк)" << endl; {
+        vector<flight> data_copy = test_data;
+        auto start = steady_clock::now();
+        auto perm = decoratedSpecialFlightSortPermutation(data_copy);
+        auto perm_end = steady_clock::now();
+        apply_permutation(data_copy, perm);
+        auto end = steady_clock::now();
+        double perm_time = duration_cast<milliseconds>(perm_end - start).count() / 1000.0;
+        double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+        results.push_back({"decoratedSpecialFlightSort", elapsed, true});
+        cout << "  Время: " << fixed << setprecision(3) << elapsed
+                << " сек (перестановка: " << perm_time << " сек)" << endl;
+
+        cout << "  Рейсы:\n";
+        for (size_t i = 0; i < min(static_cast<size_t>(3), data_copy.size()); ++i) {
+            if (i > 0) cout << ", ";
+            cout << "отм:" << (data_copy[i].is_canceled() ? "да" : "нет")
+                    << " зад:" << data_copy[i].get_arr_delay() << "мин"
+                    << ", рейс:" << data_copy[i].get_unique_key();
+        }
+        cout << endl;
+    }
+
     // Результаты
     cout << "\n--- Результаты сравнения ---" << endl;
     cout << setw(45) << left << "Алгоритм"
@@ -448,6 +905,162 @@ void compare_sorting_algorithms(const vector<flight> &test_data) {
     }
 }
 
+void compare_top_k(const vector<flight> &test_data, size_t k = 100) {
+    cout << "\n=== ТОП-" << k << " ЗАДЕРЖЕК БЕЗ ПОЛНОЙ СОРТИРОВКИ ===" << endl;
+    cout << "Векторный фильтр (AVX2): " << (column_scan_uses_avx2() ? "да" : "нет") << endl;
+
+    // Общий топ: полная устойчивая сортировка по убыванию задержки против top_k
+    using DelayDescOrder = order_by<by<&flight::get_arr_delay, desc>>;
+    auto sort_start = steady_clock::now();
+    auto perm = sortPermutationBy<DelayDescOrder>(test_data);
+    auto sort_end = steady_clock::now();
+    vector<const flight *> sorted_top;
+    for (size_t i = 0; i < min(k, perm.size()); ++i) {
+        sorted_top.push_back(&test_data[perm[i]]);
+    }
+
+    auto top_start = steady_clock::now();
+    auto top = top_k_by_arr_delay(test_data, k);
+    auto top_end = steady_clock::now();
+
+    cout << "Общий топ:" << endl;
+    cout << "  Полная сортировка: " << fixed << setprecision(2)
+            << duration<double, milli>(sort_end - sort_start).count() << " мс" << endl;
+    cout << "  top_k_by_arr_delay: " << fixed << setprecision(2)
+            << duration<double, milli>(top_end - top_start).count() << " мс" << endl;
+    cout << "  Совпадает с сортировкой: " << (top == sorted_top ? "да" : "НЕТ") << endl;
+    if (!top.empty()) {
+        cout << "  Худший рейс: " << top[0]->get_unique_key()
+                << ", " << top[0]->get_arr_delay() << " мин" << endl;
+    }
+
+    // Топ по штатам назначения: сортировка (штат, задержка по убыванию) против куч по группам
+    using StateDelayOrder = order_by<by<&flight::get_dest_state>, by<&flight::get_arr_delay, desc>>;
+    auto group_sort_start = steady_clock::now();
+    auto group_perm = sortPermutationBy<StateDelayOrder>(test_data);
+    map<string, vector<const flight *> > sorted_groups;
+    for (uint32_t index: group_perm) {
+        auto &group = sorted_groups[test_data[index].get_dest_state()];
+        if (group.size() < k) group.push_back(&test_data[index]);
+    }
+    auto group_sort_end = steady_clock::now();
+
+    auto group_top_start = steady_clock::now();
+    auto groups = top_k_by_arr_delay(test_data, k, &flight::get_dest_state);
+    auto group_top_end = steady_clock::now();
+
+    cout << "Топ по штатам (" << groups.size() << " групп):" << endl;
+    cout << "  Полная сортировка: " << fixed << setprecision(2)
+            << duration<double, milli>(group_sort_end - group_sort_start).count() << " мс" << endl;
+    cout << "  top_k_by_arr_delay(group_by): " << fixed << setprecision(2)
+            << duration<double, milli>(group_top_end - group_top_start).count() << " мс" << endl;
+    cout << "  Совпадает с сортировкой: " << (groups == sorted_groups ? "да" : "НЕТ") << endl;
+}
+
+void compare_external_sort(const string &csv_file, size_t compressed_sample_lines = 200000) {
+    cout << "\n=== ВНЕШНЯЯ СОРТИРОВКА ПО ЗАДЕРЖКЕ ПРИБЫТИЯ ===" << endl;
+
+    // Проверка результата: ключи не убывают, строк столько же, сколько во входе
+    auto check_sorted = [](const string &filename, size_t expected) {
+        ifstream in(filename);
+        string line;
+        getline(in, line);
+        size_t count = 0;
+        uint64_t previous = 0;
+        bool sorted = true;
+        while (getline(in, line)) {
+            uint64_t key = csv_arr_delay_key(line);
+            if (count > 0 && key < previous) sorted = false;
+            previous = key;
+            count++;
+        }
+        return sorted && count == expected;
+    };
+
+    auto run = [&](const string &name, const string &input, const ExternalSortOptions &options) {
+        string output = input + ".sorted";
+        auto start = steady_clock::now();
+        auto stats = external_sort_csv_by_arr_delay(input, output, options);
+        auto end = steady_clock::now();
+        double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+        cout << name << endl;
+        if (!stats.success) {
+            cout << "  Ошибка сортировки" << endl;
+            return;
+        }
+        cout << "  Записей: " << stats.records << ", серий: " << stats.runs
+                << ", проходов слияния: " << stats.merge_passes << endl;
+        cout << "  Во временные файлы: " << format_bytes(stats.spilled_bytes) << endl;
+        cout << "  Время: " << fixed << setprecision(2) << elapsed << " сек" << endl;
+        cout << "  Порядок корректен: " << (check_sorted(output, stats.records) ? "да" : "НЕТ") << endl;
+        remove(output.c_str());
+    };
+
+    ExternalSortOptions options;
+    options.memory_limit = 64 * 1024 * 1024;
+    run("Весь файл, серии по 64 MB без сжатия", csv_file, options);
+
+    // LZSS медленный, поэтому сжатие серий показывается на начале файла
+    string sample_file = csv_file + ".sample";
+    {
+        ifstream in(csv_file);
+        ofstream out(sample_file);
+        string line;
+        for (size_t i = 0; i <= compressed_sample_lines && getline(in, line); ++i) {
+            out << line << '\n';
+        }
+    }
+    options.memory_limit = 4 * 1024 * 1024;
+    options.compress_runs = false;
+    run("Первые " + to_string(compressed_sample_lines) + " строк, серии по 4 MB без сжатия", sample_file, options);
+    options.compress_runs = true;
+    run("Первые " + to_string(compressed_sample_lines) + " строк, серии по 4 MB со сжатием LZSS", sample_file, options);
+    remove(sample_file.c_str());
+}
+
+void compare_incremental_sorting(const vector<flight> &test_data, size_t batch_size = 10000,
+                                 size_t max_records = 200000) {
+    size_t total = min(max_records, test_data.size());
+    cout << "\n=== ПОДДЕРЖКА ПОРЯДКА ПРИ ДОБАВЛЕНИИ ===" << endl;
+    cout << "Записей: " << total << ", пакетами по " << batch_size
+            << ", после каждого пакета нужен отсортированный список" << endl;
+
+    // Пересортировка всего накопленного после каждого пакета
+    vector<flight> accumulated;
+    auto resort_start = steady_clock::now();
+    for (size_t begin = 0; begin < total; begin += batch_size) {
+        size_t end = min(total, begin + batch_size);
+        accumulated.insert(accumulated.end(), test_data.begin() + begin, test_data.begin() + end);
+        specialFlightSort(accumulated);
+    }
+    auto resort_end = steady_clock::now();
+
+    // Инкрементальное представление
+    SortedFlightView<SpecialFlightOrder> view;
+    size_t checked_size = 0;
+    auto view_start = steady_clock::now();
+    for (size_t begin = 0; begin < total; begin += batch_size) {
+        size_t end = min(total, begin + batch_size);
+        view.insert(test_data.begin() + begin, test_data.begin() + end);
+        checked_size = view.sorted().size();
+    }
+    auto view_end = steady_clock::now();
+
+    const auto &ordered = view.sorted();
+    bool sorted = checked_size == total;
+    for (size_t i = 1; i < ordered.size() && sorted; ++i) {
+        if (SpecialFlightOrder::compare(ordered[i], ordered[i - 1]) < 0) sorted = false;
+    }
+
+    cout << "Пересортировка (specialFlightSort): " << fixed << setprecision(3)
+            << duration<double>(resort_end - resort_start).count() << " сек" << endl;
+    cout << "SortedFlightView: " << fixed << setprecision(3)
+            << duration<double>(view_end - view_start).count() << " сек"
+            << ", перемещений при слияниях: " << view.get_merged_records() << endl;
+    cout << "Порядок корректен: " << (sorted ? "да" : "НЕТ") << endl;
+}
+
 void compare_search_algorithms(const vector<flight> &all_flights) {
     cout << "\n=== СРАВНЕНИЕ АЛГОРИТМОВ ПОИСКА ===" << endl;
     cout << "Размер данных: " << all_flights.size() << " записей" << endl;
@@ -547,6 +1160,295 @@ void compare_search_algorithms(const vector<flight> &all_flights) {
         }
     }
 
+    // Поиск диапазона индексов: без копирования найденных записей
+    cout << "\n4. Бинарный и Fibonacci поиск диапазона индексов (с std::sort)" << endl; {
+        vector<flight> sorted_flights = all_flights;
+        auto distance_getter = [](const flight &f) { return f.getDistance(); };
+
+        auto sort_start = steady_clock::now();
+        std::sort(sorted_flights.begin(), sorted_flights.end(), [](const flight &a, const flight &b) {
+            return a.getDistance() < b.getDistance();
+        });
+        auto sort_end = steady_clock::now();
+        double sort_time = duration_cast<milliseconds>(sort_end - sort_start).count() / 1000.0;
+
+        auto binary_start = steady_clock::now();
+        IndexRange binary_range = equal_range_search(sorted_flights, distance_getter, search_distance);
+        auto binary_end = steady_clock::now();
+        double binary_time = duration<double>(binary_end - binary_start).count();
+
+        auto fibonacci_start = steady_clock::now();
+        IndexRange fibonacci_range = Fibonacci_search_range(sorted_flights, distance_getter, search_distance);
+        auto fibonacci_end = steady_clock::now();
+        double fibonacci_time = duration<double>(fibonacci_end - fibonacci_start).count();
+
+        results.push_back({"Binary Range", sort_time + binary_time, sort_time, binary_range.size(), {}});
+        results.push_back({"Fibonacci Range", sort_time + fibonacci_time, sort_time, fibonacci_range.size(), {}});
+        cout << "  Время сортировки (std::sort): " << fixed << setprecision(3) << sort_time << " сек" << endl;
+        cout << "  equal_range_search: " << fixed << setprecision(2) << binary_time * 1e6 << " мкс"
+                << ", индексы [" << binary_range.first << ", " << binary_range.last << ")" << endl;
+        cout << "  Fibonacci_search_range: " << fixed << setprecision(2) << fibonacci_time * 1e6 << " мкс"
+                << ", индексы [" << fibonacci_range.first << ", " << fibonacci_range.last << ")" << endl;
+        cout << "  Найдено: " << binary_range.size() << endl;
+
+        // Вывод первых 5 прямо из отсортированного вектора
+        FlightRange found = make_flight_range(sorted_flights, binary_range);
+        cout << "  Первые 5 найденных:" << endl;
+        for (size_t i = 0; i < min(size_t(5), found.size()); ++i) {
+            cout << "    " << (i + 1) << ". " << found[i].get_unique_key()
+                    << " (дистанция: " << found[i].getDistance() << " миль)" << endl;
+        }
+    }
+
+    // Линейный поиск по столбцу дистанций (векторное сравнение)
+    cout << "\n5. Линейный поиск по столбцу (" << (column_scan_uses_avx2() ? "AVX2" : "скалярный") << ")" << endl; {
+        auto extract_start = steady_clock::now();
+        vector<float> distances = extract_column(all_flights, [](const flight &f) { return f.getDistance(); });
+        auto extract_end = steady_clock::now();
+        double extract_time = duration<double>(extract_end - extract_start).count();
+
+        auto search_start = steady_clock::now();
+        vector<size_t> hits = linear_search(distances, search_distance);
+        auto search_end = steady_clock::now();
+        double search_time = duration<double>(search_end - search_start).count();
+
+        auto between_start = steady_clock::now();
+        vector<size_t> between_hits = linear_search_between(distances, 900.0f, 1100.0f);
+        auto between_end = steady_clock::now();
+        double between_time = duration<double>(between_end - between_start).count();
+
+        results.push_back({"Column Linear Search", search_time, 0.0, hits.size(), {}});
+        cout << "  Извлечение столбца: " << fixed << setprecision(3) << extract_time * 1000 << " мс" << endl;
+        cout << "  Поиск == " << search_distance << ": " << fixed << setprecision(3) << search_time * 1000
+                << " мс, найдено: " << hits.size() << endl;
+        cout << "  Поиск 900..1100: " << fixed << setprecision(3) << between_time * 1000
+                << " мс, найдено: " << between_hits.size() << endl;
+    }
+
+    // Параллельный линейный поиск (общий пул потоков)
+    cout << "\n6. Параллельный линейный поиск (потоков в пуле: " << ThreadPool::shared().size() << ")" << endl; {
+        size_t parts = parallel_search_parts(all_flights.size(), 0);
+        auto start = steady_clock::now();
+        auto search_results = parallel_linear_search(all_flights,
+                                                     [](const flight &f) { return f.getDistance(); },
+                                                     search_distance);
+        auto end = steady_clock::now();
+        double elapsed = duration<double>(end - start).count();
+
+        results.push_back({"Parallel Linear Search", elapsed, 0.0, search_results.size(), {}});
+        cout << "  Частей: " << parts << (parts <= 1 ? " (последовательно: мало записей или один поток)" : "") << endl;
+        cout << "  Время: " << fixed << setprecision(3) << elapsed * 1000 << " мс" << endl;
+        cout << "  Найдено: " << search_results.size() << endl;
+    }
+
+    // Много запросов: раскладка ключей в памяти важнее, чем число сравнений
+    cout << "\n7. Серия запросов: Eytzinger и branchless lower_bound против binary/Fibonacci" << endl; {
+        vector<flight> sorted_flights = all_flights;
+        std::sort(sorted_flights.begin(), sorted_flights.end(), [](const flight &a, const flight &b) {
+            return a.getDistance() < b.getDistance();
+        });
+        auto distance_getter = [](const flight &f) { return f.getDistance(); };
+        vector<float> distance_keys = extract_column(sorted_flights, distance_getter);
+
+        auto build_start = steady_clock::now();
+        EytzingerIndex<float> eytzinger(distance_keys);
+        auto build_end = steady_clock::now();
+        cout << "  Построение Eytzinger: " << fixed << setprecision(3)
+                << duration<double, milli>(build_end - build_start).count() << " мс, "
+                << format_bytes(eytzinger.memory_bytes()) << endl;
+
+        // Половина запросов - существующие значения, половина - случайные (часто промахи)
+        const size_t QUERY_COUNT = 200000;
+        const size_t COPYING_QUERY_COUNT = 200;
+        vector<float> queries(QUERY_COUNT);
+        uint64_t state = 12345;
+        for (size_t i = 0; i < QUERY_COUNT; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint32_t r = static_cast<uint32_t>(state >> 33);
+            queries[i] = (i % 2 == 0 && !distance_keys.empty())
+                             ? distance_keys[r % distance_keys.size()]
+                             : static_cast<float>(r % 5000);
+        }
+
+        auto measure = [&](const string &name, size_t count, auto search) {
+            size_t checksum = 0;
+            auto start = steady_clock::now();
+            for (size_t i = 0; i < count; ++i) {
+                checksum += search(queries[i]);
+            }
+            auto end = steady_clock::now();
+            double ns = duration<double, nano>(end - start).count() / max<size_t>(count, 1);
+            cout << "  " << setw(10) << right << fixed << setprecision(1) << ns << left
+                    << " нс/запрос  " << name << " (контрольная сумма: " << checksum << ")" << endl;
+        };
+
+        measure("binary_search (копии, " + to_string(COPYING_QUERY_COUNT) + " запросов)", COPYING_QUERY_COUNT,
+                [&](float q) { return binary_search(sorted_flights, distance_getter, q).size(); });
+        measure("Fibonacci_search (копии, " + to_string(COPYING_QUERY_COUNT) + " запросов)", COPYING_QUERY_COUNT,
+                [&](float q) { return Fibonacci_search(sorted_flights, distance_getter, q).size(); });
+        measure("equal_range_search по записям", QUERY_COUNT,
+                [&](float q) { return equal_range_search(sorted_flights, distance_getter, q).size(); });
+        measure("Fibonacci_search_range по записям", QUERY_COUNT,
+                [&](float q) { return Fibonacci_search_range(sorted_flights, distance_getter, q).size(); });
+        measure("lower_bound_index по записям", QUERY_COUNT,
+                [&](float q) { return lower_bound_index(sorted_flights, distance_getter, q); });
+        measure("std::lower_bound по столбцу", QUERY_COUNT, [&](float q) {
+            return static_cast<size_t>(std::lower_bound(distance_keys.begin(), distance_keys.end(), q) -
+                                       distance_keys.begin());
+        });
+        measure("branchless_lower_bound по столбцу", QUERY_COUNT,
+                [&](float q) { return branchless_lower_bound(distance_keys, q); });
+        measure("EytzingerIndex::lower_bound", QUERY_COUNT,
+                [&](float q) { return eytzinger.lower_bound(q); });
+        measure("EytzingerIndex::equal_range", QUERY_COUNT,
+                [&](float q) { return eytzinger.equal_range(q).size(); });
+    }
+
+    // Интерполяционный и экспоненциальный поиск на числовых ключах
+    cout << "\n8. Интерполяционный и экспоненциальный поиск (дистанция и задержка прибытия)" << endl; {
+        auto run_key = [&](const string &key_name, auto getter) {
+            vector<flight> sorted_flights = all_flights;
+            std::sort(sorted_flights.begin(), sorted_flights.end(), [&](const flight &a, const flight &b) {
+                return getter(a) < getter(b);
+            });
+            if (sorted_flights.empty()) return;
+
+            // Половина запросов - существующие значения, половина - из диапазона ключей
+            const size_t QUERY_COUNT = 100000;
+            float min_value = getter(sorted_flights.front());
+            float max_value = getter(sorted_flights.back());
+            vector<float> queries(QUERY_COUNT);
+            uint64_t state = 54321;
+            for (size_t i = 0; i < QUERY_COUNT; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                uint32_t r = static_cast<uint32_t>(state >> 33);
+                queries[i] = i % 2 == 0
+                                 ? getter(sorted_flights[r % sorted_flights.size()])
+                                 : min_value + (max_value - min_value) * (r % 100000) / 100000.0f;
+            }
+
+            cout << "  Ключ: " << key_name << " (" << min_value << " .. " << max_value << ")" << endl;
+            auto measure = [&](const string &name, auto search) {
+                size_t probes = 0;
+                auto counting_getter = [&](const flight &f) {
+                    probes++;
+                    return getter(f);
+                };
+                size_t found = 0;
+                auto start = steady_clock::now();
+                for (float q: queries) {
+                    found += search(sorted_flights, counting_getter, q).size();
+                }
+                auto end = steady_clock::now();
+                double ns = duration<double, nano>(end - start).count() / QUERY_COUNT;
+                cout << "    " << setw(10) << right << fixed << setprecision(1) << ns << left
+                        << " нс/запрос, " << setprecision(1) << static_cast<double>(probes) / QUERY_COUNT
+                        << " проб/запрос  " << name << " (найдено всего: " << found << ")" << endl;
+            };
+            measure("equal_range_search", [](const auto &f, auto g, float q) { return equal_range_search(f, g, q); });
+            measure("Fibonacci_search_range",
+                    [](const auto &f, auto g, float q) { return Fibonacci_search_range(f, g, q); });
+            measure("interpolation_search_range",
+                    [](const auto &f, auto g, float q) { return interpolation_search_range(f, g, q); });
+            measure("exponential_search_range",
+                    [](const auto &f, auto g, float q) { return exponential_search_range(f, g, q); });
+        };
+
+        run_key("дистанция", [](const flight &f) { return f.getDistance(); });
+        run_key("задержка прибытия", [](const flight &f) { return f.get_arr_delay(); });
+    }
+
+    // Много ключей за один вызов: сортированный проход, конвейер бинарных поисков и хеш-индекс
+    cout << "\n9. Пакетный поиск (дистанция и номер рейса)" << endl; {
+        auto run_key = [&](const string &key_name, auto getter) {
+            vector<flight> sorted_flights = all_flights;
+            std::sort(sorted_flights.begin(), sorted_flights.end(), [&](const flight &a, const flight &b) {
+                return getter(a) < getter(b);
+            });
+            if (sorted_flights.empty()) return;
+            vector<float> keys = extract_column(sorted_flights, getter);
+
+            // Половина запросов - существующие значения, половина - случайные (часто промахи)
+            const size_t QUERY_COUNT = 200000;
+            float max_value = keys.back();
+            vector<float> queries(QUERY_COUNT);
+            uint64_t state = 777;
+            for (size_t i = 0; i < QUERY_COUNT; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                uint32_t r = static_cast<uint32_t>(state >> 33);
+                queries[i] = i % 2 == 0 ? keys[r % keys.size()] : static_cast<float>(r % (static_cast<uint32_t>(max_value) + 1));
+            }
+
+            auto build_start = steady_clock::now();
+            KeyHashIndex<float> hash_index(keys);
+            auto build_end = steady_clock::now();
+            unordered_map<float, IndexRange> hash_map;
+            for (size_t first = 0; first < keys.size();) {
+                size_t last = upper_bound_index(sorted_flights, getter, keys[first], first);
+                hash_map[keys[first]] = { first, last };
+                first = last;
+            }
+
+            cout << "  Ключ: " << key_name << ", различных значений: " << hash_index.distinct_count()
+                    << ", KeyHashIndex: " << format_bytes(hash_index.memory_bytes()) << ", построение "
+                    << fixed << setprecision(3) << duration<double, milli>(build_end - build_start).count()
+                    << " мс" << endl;
+
+            // search() возвращает контрольную сумму по всем запросам
+            auto measure = [&](const string &name, auto search) {
+                auto start = steady_clock::now();
+                size_t checksum = search();
+                auto end = steady_clock::now();
+                double ns = duration<double, nano>(end - start).count() / QUERY_COUNT;
+                cout << "    " << setw(10) << right << fixed << setprecision(1) << ns << left
+                        << " нс/запрос  " << name << " (контрольная сумма: " << checksum << ")" << endl;
+            };
+            auto range_sum = [](const vector<IndexRange> &ranges) {
+                size_t sum = 0;
+                for (const auto &r: ranges) sum += r.size();
+                return sum;
+            };
+
+            measure("equal_range_search по одному", [&] {
+                size_t sum = 0;
+                for (float q: queries) sum += equal_range_search(sorted_flights, getter, q).size();
+                return sum;
+            });
+            measure("batch_equal_range_search (сортировка запросов + проход)", [&] {
+                return range_sum(batch_equal_range_search(sorted_flights, getter, queries));
+            });
+            measure("std::lower_bound по столбцу по одному", [&] {
+                size_t sum = 0;
+                for (float q: queries) {
+                    sum += static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), q) - keys.begin());
+                }
+                return sum;
+            });
+            measure("batch_lower_bound (группы по " + to_string(BATCH_SEARCH_GROUP) + ", prefetch)", [&] {
+                size_t sum = 0;
+                for (size_t position: batch_lower_bound(keys, queries)) sum += position;
+                return sum;
+            });
+            measure("unordered_map<float, IndexRange>::find по одному", [&] {
+                size_t sum = 0;
+                for (float q: queries) {
+                    auto it = hash_map.find(q);
+                    if (it != hash_map.end()) sum += it->second.size();
+                }
+                return sum;
+            });
+            measure("KeyHashIndex::find по одному", [&] {
+                size_t sum = 0;
+                for (float q: queries) sum += hash_index.find(q).size();
+                return sum;
+            });
+            measure("KeyHashIndex::find_batch", [&] { return range_sum(hash_index.find_batch(queries)); });
+        };
+
+        run_key("дистанция", [](const flight &f) { return f.getDistance(); });
+        run_key("номер рейса", [](const flight &f) { return f.get_flight_number(); });
+    }
+
     cout << "\n--- Результаты сравнения ---" << endl;
     cout << setw(25) << left << "Алгоритм"
             << setw(18) << "Время поиска"
@@ -554,11 +1456,273 @@ void compare_search_algorithms(const vector<flight> &all_flights) {
     cout << string(76, '-') << endl;
     for (const auto &r: results) {
         cout << setw(25) << left << r.name
-                << setw(18) << fixed << setprecision(3) << (r.time_seconds)
+                << setw(18) << fixed << setprecision(6) << (r.time_seconds)
                 << r.results_count << endl;
     }
 }
 
+void compare_export_methods(const unordered_set<flight> &flights, const string &base_name) {
+    cout << "\n=== СРАВНЕНИЕ МЕТОДОВ ЭКСПОРТА CSV ===" << endl;
+    cout << "Записей: " << flights.size() << endl;
+
+    FlightOrganizer organizer;
+    for (const auto &f: flights) {
+        organizer.add_flight(f);
+    }
+
+    auto read_file = [](const string &filename) {
+        ifstream in(filename, ios::binary);
+        return string((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    };
+
+    struct ExportVariant {
+        string name;
+        CsvWriteMode mode;
+        size_t threads;
+    };
+    size_t threads = ThreadPool::default_thread_count();
+    vector<ExportVariant> variants = {
+        {"stream (исходный)", CsvWriteMode::Stream, 1},
+        {"buffered", CsvWriteMode::Buffered, 1},
+        {"buffered x" + to_string(threads), CsvWriteMode::Buffered, threads},
+        {"csv2::Writer", CsvWriteMode::Csv2, 1},
+    };
+
+    for (int target = 0; target < 2; ++target) {
+        cout << (target == 0 ? "\nFlightOrganizer::save_to_csv" : "\nsave_unique_keys_to_csv") << endl;
+        cout << setw(25) << left << "Метод"
+                << setw(15) << "Время (сек)"
+                << setw(15) << "Размер"
+                << "Совпадает" << endl;
+        cout << string(65, '-') << endl;
+
+        string reference;
+        for (const auto &v: variants) {
+            string filename = base_name + ".export.csv";
+            auto start = steady_clock::now();
+            if (target == 0) {
+                organizer.save_to_csv(filename, v.mode, v.threads);
+            } else {
+                save_unique_keys_to_csv(flights, filename, v.mode, v.threads);
+            }
+            auto end = steady_clock::now();
+            double elapsed = duration_cast<milliseconds>(end - start).count() / 1000.0;
+
+            string content = read_file(filename);
+            remove(filename.c_str());
+            if (v.mode == CsvWriteMode::Stream) {
+                reference = content;
+            }
+
+            cout << setw(25) << left << v.name
+                    << setw(15) << fixed << setprecision(3) << elapsed
+                    << setw(15) << format_bytes(content.size())
+                    << (content == reference ? "да" : "НЕТ") << endl;
+        }
+    }
+}
+
+void compare_place_search(const vector<flight> &all_flights, const PlaceNameIndex &place_index, double build_ms) {
+    cout << "\n=== ПОИСК ГОРОДОВ И АЭРОПОРТОВ ПО ПРЕФИКСУ И С ОПЕЧАТКАМИ ===" << endl;
+    cout << "Мест: " << place_index.size() << ", узлов дерева: " << place_index.get_node_count()
+            << ", память: " << format_bytes(place_index.memory_bytes())
+            << ", построение: " << fixed << setprecision(1) << build_ms << " мс (" << all_flights.size()
+            << " записей)" << endl;
+    if (place_index.size() == 0) return;
+
+    // Запросы автодополнения: префиксы длины 1..3 всех имен
+    vector<string> prefixes;
+    for (uint32_t id = 0; id < place_index.size(); ++id) {
+        const string &name = place_index.get_name(id);
+        for (size_t len = 1; len <= 3 && len <= name.size(); ++len) {
+            prefixes.push_back(name.substr(0, len));
+        }
+    }
+    const size_t LIMIT = 10;
+
+    auto measure = [&](const string &name, auto search) {
+        size_t total = 0;
+        auto start = steady_clock::now();
+        for (const auto &prefix: prefixes) {
+            total += search(prefix);
+        }
+        auto end = steady_clock::now();
+        double us = duration<double, micro>(end - start).count() / max<size_t>(prefixes.size(), 1);
+        cout << "  " << setw(10) << right << fixed << setprecision(3) << us << left
+                << " мкс/запрос  " << name << " (подсказок всего: " << total << ")" << endl;
+    };
+    cout << "Автодополнение, " << prefixes.size() << " префиксов, до " << LIMIT << " подсказок:" << endl;
+    measure("find_prefix", [&](const string &prefix) { return place_index.find_prefix(prefix, LIMIT).size(); });
+    measure("перебор имен с нормализацией", [&](const string &prefix) {
+        string normalized = PlaceNameIndex::normalize(prefix);
+        size_t found = 0;
+        for (uint32_t id = 0; id < place_index.size() && found < LIMIT; ++id) {
+            if (PlaceNameIndex::normalize(place_index.get_name(id)).compare(0, normalized.size(), normalized) == 0) {
+                found++;
+            }
+        }
+        return found;
+    });
+
+    auto describe = [&](uint32_t id) {
+        return place_index.get_name(id) + (place_index.get_kind(id) == PlaceKind::City ? " (город, " : " (аэропорт, ")
+               + to_string(place_index.get_flights(id).size()) + " рейсов)";
+    };
+
+    for (const char *prefix: {"New", "San", "CH"}) {
+        auto matches = place_index.find_prefix(prefix, 5);
+        cout << "\n  \"" << prefix << "\":" << endl;
+        for (uint32_t id: matches) {
+            cout << "    " << describe(id) << endl;
+        }
+    }
+
+    // Опечатки: в начале имени (автодополнение) и в коде аэропорта целиком
+    auto show_fuzzy = [&](const string &query, bool by_prefix) {
+        auto start = steady_clock::now();
+        auto matches = by_prefix ? place_index.find_fuzzy_prefix(query, 2, 5) : place_index.find_fuzzy(query, 2, 5);
+        auto end = steady_clock::now();
+        cout << "\n  \"" << query << "\" (" << (by_prefix ? "find_fuzzy_prefix" : "find_fuzzy") << ", расстояние <= 2, "
+                << fixed << setprecision(1) << duration<double, micro>(end - start).count() << " мкс):" << endl;
+        for (const auto &match: matches) {
+            cout << "    [" << match.distance << "] " << describe(match.id) << endl;
+        }
+    };
+    for (const char *typo: {"Chicgo", "Los Angelos", "Dalas", "Sna Fran"}) {
+        show_fuzzy(typo, true);
+    }
+    show_fuzzy("JKF", false);
+}
+
+void stress_concurrent_organizer(const vector<flight> &test_data, size_t reader_threads = 8) {
+    cout << "\n=== КОНКУРЕНТНЫЙ ДОСТУП К ORGANIZER ===" << endl;
+    cout << "Писатель: 1 поток, читателей: " << reader_threads << endl;
+
+    // Публикует сам писатель, чтобы было известно, когда идет публикация
+    const size_t PUBLISH_BATCH = 8192;
+    ConcurrentFlightOrganizer organizer(test_data.size() + 1);
+    atomic<bool> ingest_done{false};
+    atomic<bool> publishing{false};
+    atomic<size_t> violations{0};
+
+    vector<string> carriers;
+    for (const auto &f: test_data) {
+        if (find(carriers.begin(), carriers.end(), f.get_carrier_id()) == carriers.end()) {
+            carriers.push_back(f.get_carrier_id());
+        }
+    }
+
+    // Прогресс читателя: запросы и самый долгий запрос вне публикаций и во время них
+    struct ReaderProgress {
+        size_t queries = 0;
+        size_t queries_during_publish = 0;
+        double max_query_us = 0.0;
+        double max_query_during_publish_us = 0.0;
+    };
+    vector<ReaderProgress> progress(reader_threads);
+    size_t publications = 0;
+    double publish_ms = 0.0;
+    double max_publish_ms = 0.0;
+
+    auto start = steady_clock::now();
+
+    thread writer([&]() {
+        for (size_t i = 0; i < test_data.size(); ++i) {
+            organizer.add_flight(test_data[i]);
+            if ((i + 1) % PUBLISH_BATCH == 0 || i + 1 == test_data.size()) {
+                publishing = true;
+                auto publish_start = steady_clock::now();
+                organizer.publish();
+                auto publish_end = steady_clock::now();
+                publishing = false;
+                double ms = duration<double, milli>(publish_end - publish_start).count();
+                publications++;
+                publish_ms += ms;
+                max_publish_ms = max(max_publish_ms, ms);
+            }
+        }
+        ingest_done = true;
+    });
+
+    vector<thread> readers;
+    for (size_t t = 0; t < reader_threads; ++t) {
+        readers.emplace_back([&, t]() {
+            ReaderProgress &my = progress[t];
+            size_t last_count = 0;
+            size_t i = t;
+            while (!ingest_done || my.queries == 0) {
+                const flight &probe = test_data[i % test_data.size()];
+                i += reader_threads;
+
+                // Запросы через организатор: сверка версии без блокировок
+                bool during_publish = publishing;
+                auto query_start = steady_clock::now();
+                size_t count = organizer.get_unique_flights_count();
+                bool found = organizer.contains(probe.get_unique_key());
+                auto query_end = steady_clock::now();
+                double us = duration<double, micro>(query_end - query_start).count();
+                during_publish = during_publish || publishing;
+
+                my.queries += 2;
+                my.max_query_us = max(my.max_query_us, us);
+                if (during_publish) {
+                    my.queries_during_publish += 2;
+                    my.max_query_during_publish_us = max(my.max_query_during_publish_us, us);
+                }
+
+                // Снимки публикуются по порядку: размер не может уменьшиться
+                if (count < last_count) violations++;
+                last_count = count;
+                if (found && organizer.get_flights_by_aircraft(probe.get_carrier_id(),
+                                                               probe.get_flight_number()).empty()) {
+                    violations++;
+                }
+
+                // Изредка - полная проверка одного снимка: рейсы всех перевозчиков дают общий размер
+                if (i % (64 * reader_threads) == t) {
+                    auto snap = organizer.snapshot();
+                    size_t by_carriers = 0;
+                    for (const auto &c: carriers) {
+                        by_carriers += snap->get_flights_by_carrier(c).size();
+                    }
+                    if (by_carriers != snap->get_unique_flights_count()) violations++;
+                }
+            }
+        });
+    }
+
+    writer.join();
+    for (auto &r: readers) {
+        r.join();
+    }
+    auto end = steady_clock::now();
+    double elapsed_ms = duration<double, milli>(end - start).count();
+
+    ReaderProgress total;
+    for (const auto &p: progress) {
+        total.queries += p.queries;
+        total.queries_during_publish += p.queries_during_publish;
+        total.max_query_us = max(total.max_query_us, p.max_query_us);
+        total.max_query_during_publish_us = max(total.max_query_during_publish_us, p.max_query_during_publish_us);
+    }
+    double outside_ms = max(elapsed_ms - publish_ms, 1e-9);
+
+    auto snap = organizer.snapshot();
+    cout << "  Уникальных рейсов: " << snap->get_unique_flights_count()
+            << " (сегментов: " << snap->get_segment_count() << ", версия: " << organizer.get_version() << ")" << endl;
+    cout << "  Время: " << fixed << setprecision(3) << elapsed_ms / 1000.0 << " сек" << endl;
+    cout << "  Публикаций: " << publications << ", суммарно " << setprecision(1) << publish_ms
+            << " мс, самая долгая " << max_publish_ms << " мс" << endl;
+    cout << "  Запросов читателей: " << total.queries << ", из них во время публикаций: "
+            << total.queries_during_publish << endl;
+    cout << "  Запросов в мс: во время публикаций " << setprecision(1)
+            << total.queries_during_publish / max(publish_ms, 1e-9)
+            << ", вне публикаций " << (total.queries - total.queries_during_publish) / outside_ms << endl;
+    cout << "  Самый долгий запрос: " << setprecision(1) << total.max_query_us << " мкс, во время публикации "
+            << total.max_query_during_publish_us << " мкс" << endl;
+    cout << "  Нарушений согласованности: " << violations << endl;
+}
+
 int main() {
     auto program_start = steady_clock::now();
 
@@ -599,9 +1763,24 @@ int main() {
     cout << "Общий размер данных: " << all_flights.size() << " записей" << endl;
     cout << "Размер тестовой выборки (для сортировки/поиска): " << test_sample.size() << " записей" << endl;
 
+    // Сравнение методов экспорта (на всех уникальных рейсах)
+    compare_export_methods(flights, CSV_FILE);
+
     // Сравнение типов хранения (на тестовой выборке)
     compare_storage_types(test_sample);
 
+    // Память всех контейнеров и индексов организатора
+    report_organizer_memory(test_sample);
+
+    // Фильтр Блума перед поиском отсутствующих ключей (на тестовой выборке)
+    compare_key_filter(test_sample);
+
+    // Индекс по времени вылета против линейного фильтра
+    compare_time_index(test_sample);
+
+    // Составные фильтры по битовым индексам против полного обхода
+    compare_bitmap_index(test_sample);
+
     // Сжатие ВСЕГО датасета
     cout << "\n=== СЖАТИЕ ДАННЫХ (весь файл) ===" << endl;
     string compressed_file = CSV_FILE + ".lzss";
@@ -629,9 +1808,21 @@ int main() {
     // Сравнение алгоритмов сортировки (на тестовой выборке)
     compare_sorting_algorithms(test_sample);
 
+    // Топ-K худших задержок (на тестовой выборке)
+    compare_top_k(test_sample);
+
+    // Инкрементальная поддержка порядка вместо пересортировки
+    compare_incremental_sorting(test_sample);
+
+    // Внешняя сортировка файла с ограничением памяти
+    compare_external_sort(CSV_FILE);
+
     // Сравнение алгоритмов поиска (на тестовой выборке)
     compare_search_algorithms(test_sample);
 
+    // Многопоточные запросы во время загрузки (на тестовой выборке)
+    stress_concurrent_organizer(test_sample);
+
     // Граф и алгоритм Дейкстры
     cout << "\n=== ПОСТРОЕНИЕ ГРАФА ГОРОДОВ ===" << endl;
     Graph cityGraph;
@@ -656,6 +1847,12 @@ int main() {
         cityGraph.addEdge(conn.first.first, conn.first.second, conn.second, true);
     }
 
+    PlaceNameIndex place_index;
+    auto place_start = steady_clock::now();
+    place_index.build(all_flights);
+    auto place_end = steady_clock::now();
+    compare_place_search(all_flights, place_index, duration<double, milli>(place_end - place_start).count());
+
     cout << "Вершин (городов): " << cityGraph.getVertexCount() << endl;
     cout << "Ребер (маршрутов): " << cityGraph.getEdgeCount() << endl;
 
@@ -665,19 +1862,24 @@ int main() {
         string startCity = vertices[0];
         string endCity = vertices.size() > 1 ? vertices[1] : vertices[0];
 
-        for (const auto &v: vertices) {
-            if (v.find("New_York") != string::npos) {
-                startCity = v;
-                break;
+        // Первый город графа, имя которого начинается с prefix
+        auto find_city = [&](const string &prefix, const string &except) {
+            for (uint32_t id: place_index.find_prefix(prefix)) {
+                const string &name = place_index.get_name(id);
+                if (place_index.get_kind(id) == PlaceKind::City && name != except && cityGraph.hasVertex(name)) {
+                    return name;
+                }
             }
-        }
+            return string();
+        };
+
+        string found = find_city("New_York", "");
+        if (!found.empty()) startCity = found;
 
-        for (const auto &v: vertices) {
-            if (v != startCity &&
-                (v.find("Los_Angeles") != string::npos ||
-                 v.find("Chicago") != string::npos ||
-                 v.find("Miami") != string::npos)) {
-                endCity = v;
+        for (const char *prefix: {"Los_Angeles", "Chicago", "Miami"}) {
+            found = find_city(prefix, startCity);
+            if (!found.empty()) {
+                endCity = found;
                 break;
             }
         }
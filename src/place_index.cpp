@@ -0,0 +1,235 @@
+#include "place_index.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+
+using namespace std;
+
+string PlaceNameIndex::normalize(const string& name) {
+    string result(name);
+    for (char& c : result) {
+        if (c == '_') c = ' ';
+        else if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return result;
+}
+
+void PlaceNameIndex::build(const vector<flight>& flights) {
+    build_from(flights);
+}
+
+void PlaceNameIndex::build(const FlightUnorderedSet& flights) {
+    build_from(flights);
+}
+
+void PlaceNameIndex::clear() {
+    places.clear();
+    flight_refs.clear();
+    nodes.clear();
+    edge_labels.clear();
+    edge_targets.clear();
+}
+
+template<typename Container>
+void PlaceNameIndex::build_from(const Container& flights) {
+    clear();
+
+    // Рейсы каждого места; рейс из города в тот же город учитывается один раз
+    map<pair<string, PlaceKind>, vector<const flight*>> linked;
+    auto link = [&](const string& name, PlaceKind kind, const flight& f) {
+        if (name.empty()) return;
+        auto& list = linked[{ name, kind }];
+        if (list.empty() || list.back() != &f) list.push_back(&f);
+    };
+    for (const auto& f : flights) {
+        link(f.getOriginCity(), PlaceKind::City, f);
+        link(f.getDestCity(), PlaceKind::City, f);
+        link(f.get_origin_code(), PlaceKind::Airport, f);
+        link(f.get_dest_code(), PlaceKind::Airport, f);
+    }
+
+    vector<string> keys;
+    keys.reserve(linked.size());
+    for (const auto& entry : linked) {
+        keys.push_back(normalize(entry.first.first));
+    }
+    vector<uint32_t> order(keys.size());
+    iota(order.begin(), order.end(), 0u);
+    // map уже упорядочен по исходному имени и виду, устойчивая сортировка сохраняет этот порядок среди равных ключей
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    vector<const pair<const pair<string, PlaceKind>, vector<const flight*>>*> entries;
+    entries.reserve(linked.size());
+    for (const auto& entry : linked) {
+        entries.push_back(&entry);
+    }
+
+    vector<string> sorted_keys;
+    sorted_keys.reserve(keys.size());
+    places.reserve(keys.size());
+    for (uint32_t i : order) {
+        const auto& entry = *entries[i];
+        uint32_t begin = static_cast<uint32_t>(flight_refs.size());
+        flight_refs.insert(flight_refs.end(), entry.second.begin(), entry.second.end());
+        places.push_back({ entry.first.first, entry.first.second, begin, static_cast<uint32_t>(flight_refs.size()) });
+        sorted_keys.push_back(move(keys[i]));
+    }
+
+    add_node(sorted_keys, 0, static_cast<uint32_t>(sorted_keys.size()), 0);
+}
+
+// Узел для ключей [begin, end), у которых совпадают первые depth символов.
+// Дуги узла резервируются подряд до построения потомков
+uint32_t PlaceNameIndex::add_node(const vector<string>& keys, uint32_t begin, uint32_t end, size_t depth) {
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({ 0, 0, begin, begin, end });
+
+    // Ключи, закончившиеся на этой глубине, идут в диапазоне первыми
+    uint32_t terminal_end = begin;
+    while (terminal_end < end && keys[terminal_end].size() == depth) terminal_end++;
+
+    vector<pair<uint32_t, uint32_t>> groups;
+    for (uint32_t i = terminal_end; i < end;) {
+        uint32_t j = i + 1;
+        while (j < end && keys[j][depth] == keys[i][depth]) j++;
+        groups.push_back({ i, j });
+        i = j;
+    }
+
+    uint32_t edge_begin = static_cast<uint32_t>(edge_labels.size());
+    for (const auto& group : groups) {
+        edge_labels.push_back(static_cast<uint8_t>(keys[group.first][depth]));
+        edge_targets.push_back(0);
+    }
+    nodes[index].edge_begin = edge_begin;
+    nodes[index].edge_count = static_cast<uint32_t>(groups.size());
+    nodes[index].terminal_end = terminal_end;
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        uint32_t child = add_node(keys, groups[g].first, groups[g].second, depth + 1);
+        edge_targets[edge_begin + g] = child;
+    }
+    return index;
+}
+
+// Узел, в который ведет путь normalized, или NOT_FOUND
+uint32_t PlaceNameIndex::descend(const string& normalized) const {
+    if (nodes.empty()) return NOT_FOUND;
+    uint32_t node = 0;
+    for (char ch : normalized) {
+        // Дуги упорядочены как std::string, то есть по байтам без знака
+        uint8_t c = static_cast<uint8_t>(ch);
+        const Node& n = nodes[node];
+        auto first = edge_labels.begin() + n.edge_begin;
+        auto last = first + n.edge_count;
+        auto it = lower_bound(first, last, c);
+        if (it == last || *it != c) return NOT_FOUND;
+        node = edge_targets[static_cast<size_t>(it - edge_labels.begin())];
+    }
+    return node;
+}
+
+uint32_t PlaceNameIndex::find(const string& name, PlaceKind kind) const {
+    uint32_t node = descend(normalize(name));
+    if (node == NOT_FOUND) return NOT_FOUND;
+    for (uint32_t id = nodes[node].place_begin; id < nodes[node].terminal_end; ++id) {
+        if (places[id].kind == kind) return id;
+    }
+    return NOT_FOUND;
+}
+
+vector<uint32_t> PlaceNameIndex::find_prefix(const string& prefix, size_t limit) const {
+    vector<uint32_t> result;
+    uint32_t node = descend(normalize(prefix));
+    if (node == NOT_FOUND) return result;
+    const Node& n = nodes[node];
+    size_t count = min<size_t>(n.place_end - n.place_begin, limit);
+    result.resize(count);
+    iota(result.begin(), result.end(), n.place_begin);
+    return result;
+}
+
+vector<PlaceMatch> PlaceNameIndex::find_fuzzy(const string& name, unsigned max_distance, size_t limit) const {
+    return fuzzy_search(name, max_distance, limit, false);
+}
+
+vector<PlaceMatch> PlaceNameIndex::find_fuzzy_prefix(const string& prefix, unsigned max_distance, size_t limit) const {
+    return fuzzy_search(prefix, max_distance, limit, true);
+}
+
+vector<PlaceMatch> PlaceNameIndex::fuzzy_search(const string& name, unsigned max_distance, size_t limit,
+                                                bool by_prefix) const {
+    vector<PlaceMatch> result;
+    if (nodes.empty()) return result;
+    string query = normalize(name);
+
+    // rows[d * (m + 1) + j] - расстояние между первыми d символами пути и первыми j символами запроса
+    size_t m = query.size();
+    vector<unsigned> rows(m + 1);
+    iota(rows.begin(), rows.end(), 0u);
+    fuzzy_visit(0, query, rows, 0, max_distance, by_prefix, UINT32_MAX, result);
+
+    sort(result.begin(), result.end(), [](const PlaceMatch& a, const PlaceMatch& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+    });
+    if (result.size() > limit) result.resize(limit);
+    return result;
+}
+
+void PlaceNameIndex::fuzzy_visit(uint32_t node, const string& query, vector<unsigned>& rows, size_t depth,
+                                 unsigned max_distance, bool by_prefix, unsigned best,
+                                 vector<PlaceMatch>& out) const {
+    size_t m = query.size();
+    const Node& n = nodes[node];
+    unsigned distance = rows[depth * (m + 1) + m];
+    if (by_prefix) {
+        best = min(best, distance);
+        distance = best;
+    }
+    if (distance <= max_distance) {
+        for (uint32_t id = n.place_begin; id < n.terminal_end; ++id) {
+            out.push_back({ id, distance });
+        }
+    }
+
+    rows.resize((depth + 2) * (m + 1));
+    for (uint32_t e = n.edge_begin; e < n.edge_begin + n.edge_count; ++e) {
+        char c = static_cast<char>(edge_labels[e]);
+        const unsigned* prev = rows.data() + depth * (m + 1);
+        unsigned* row = rows.data() + (depth + 1) * (m + 1);
+        row[0] = prev[0] + 1;
+        unsigned row_min = row[0];
+        for (size_t j = 1; j <= m; ++j) {
+            unsigned substitute = prev[j - 1] + (query[j - 1] == c ? 0 : 1);
+            row[j] = min({ prev[j] + 1, row[j - 1] + 1, substitute });
+            row_min = min(row_min, row[j]);
+        }
+        if (row_min <= max_distance) {
+            fuzzy_visit(edge_targets[e], query, rows, depth + 1, max_distance, by_prefix, best, out);
+        }
+        else if (by_prefix && best <= max_distance) {
+            // Расстояние дальше не уменьшится: все поддерево получает best
+            const Node& child = nodes[edge_targets[e]];
+            for (uint32_t id = child.place_begin; id < child.place_end; ++id) {
+                out.push_back({ id, best });
+            }
+        }
+    }
+}
+
+PlaceFlights PlaceNameIndex::get_flights(uint32_t id) const {
+    const Place& p = places[id];
+    return { flight_refs.data() + p.flights_begin, flight_refs.data() + p.flights_end };
+}
+
+size_t PlaceNameIndex::memory_bytes() const {
+    size_t bytes = places.capacity() * sizeof(Place)
+        + flight_refs.capacity() * sizeof(const flight*)
+        + nodes.capacity() * sizeof(Node)
+        + edge_labels.capacity() * sizeof(uint8_t)
+        + edge_targets.capacity() * sizeof(uint32_t);
+    for (const auto& p : places) {
+        if (p.name.capacity() > 15) bytes += p.name.capacity() + 1;
+    }
+    return bytes;
+}
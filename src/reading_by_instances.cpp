@@ -6,6 +6,7 @@
 
 // Опционально: если есть библиотека csv2
  #include <csv2/reader.hpp>
+#include <csv2/writer.hpp>
 
 using namespace std;
 
@@ -51,20 +52,55 @@ vector<string> sep_line(const string& line) {
 // ФУНКЦИЯ СОХРАНЕНИЯ
 // ============================================
 
-void save_unique_keys_to_csv(const unordered_set<flight>& flights, const string& filename) {
-    ofstream out_file(filename);
-    if (!out_file.is_open()) {
-        cout << "Cannot open file for writing: " << filename << endl;
-        return;
-    }
+void save_unique_keys_to_csv(const unordered_set<flight>& flights, const string& filename,
+                             CsvWriteMode mode, size_t threads) {
+    if (mode == CsvWriteMode::Stream) {
+        ofstream out_file(filename);
+        if (!out_file.is_open()) {
+            cout << "Cannot open file for writing: " << filename << endl;
+            return;
+        }
+
+        out_file << "unique_key\n";
 
-    out_file << "unique_key\n";
+        for (const auto& f : flights) {
+            out_file << f.get_unique_key() << "\n";
+        }
 
-    for (const auto& f : flights) {
-        out_file << f.get_unique_key() << "\n";
+        out_file.close();
+    }
+    else if (mode == CsvWriteMode::Csv2) {
+        ofstream out_file(filename);
+        if (!out_file.is_open()) {
+            cout << "Cannot open file for writing: " << filename << endl;
+            return;
+        }
+
+        csv2::Writer<csv2::delimiter<','>> writer(out_file);
+        vector<string> row(1, "unique_key");
+        writer.write_row(row);
+        for (const auto& f : flights) {
+            row[0].clear();
+            f.append_unique_key(row[0]);
+            writer.write_row(row);
+        }
+    }
+    else {
+        vector<const flight*> records;
+        records.reserve(flights.size());
+        for (const auto& f : flights) {
+            records.push_back(&f);
+        }
+        auto format = [](string& out, const flight& f) {
+            f.append_unique_key(out);
+            out += '\n';
+        };
+        if (!write_csv_buffered(filename, "unique_key\n", records, format, threads)) {
+            cout << "Cannot open file for writing: " << filename << endl;
+            return;
+        }
     }
 
-    out_file.close();
     cout << "Saved " << flights.size() << " unique flight keys to " << filename << endl;
 }
 
@@ -0,0 +1,356 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <cstdlib>
+#include <sstream>
+#include <iterator>
+#include <cstdint>
+
+#include "flight.h"
+#include "reading_by_instances.h"
+#include "benchmark_table.h"
+#include "column_scan.h"
+#include "Search_Algs.h"
+
+// Бенчмарк поиска: для каждого ключа (дистанция, задержка прибытия, номер рейса)
+// тысячи случайных запросов, половина - существующие значения, половина - промахи
+// внутри диапазона ключей. Каждый запрос замеряется отдельно (за вычетом стоимости
+// самого замера), выводятся среднее и перцентили нс/запрос, отдельно медианы для
+// попаданий и промахов, стоимость подготовки (сортировка, столбец, индекс) и число
+// запросов, после которого подготовка окупается по сравнению с линейным поиском.
+//
+// Перед этим поиск проверяется на виртуальном столбце больше 2^32 элементов.
+//
+// Запуск: SearchBenchmark [csv-файл] [макс. записей, 0 = все] [запросов на ключ]
+
+using namespace std;
+using namespace std::chrono;
+
+// Линейный поиск обходит все записи, поэтому для него запросов меньше
+const size_t LINEAR_QUERY_LIMIT = 200;
+const size_t WARMUP_QUERIES = 1000;
+
+// Алгоритм поиска; prepare_ms - стоимость подготовки нужных ему структур
+// (сортировка, столбец, индекс). Пакетный алгоритм отвечает на все запросы сразу
+struct SearchAlgorithm {
+    string name;
+    double prepare_ms;
+    function<size_t(float)> search;                                  // число найденных записей
+    function<vector<size_t>(const vector<float> &)> batch = nullptr;   // для пакетных: ответы по запросам
+    bool limited = false;                                            // только LINEAR_QUERY_LIMIT запросов
+};
+
+string format_number(double value, int precision) {
+    ostringstream out;
+    out << fixed << setprecision(precision) << value;
+    return out.str();
+}
+
+template<typename Function>
+double time_ms(Function function) {
+    auto start = steady_clock::now();
+    function();
+    auto end = steady_clock::now();
+    return duration<double, milli>(end - start).count();
+}
+
+// Стоимость пары вызовов steady_clock::now(), вычитается из замера каждого запроса
+double timer_overhead_ns() {
+    vector<double> samples(10000);
+    for (auto &sample: samples) {
+        auto start = steady_clock::now();
+        auto end = steady_clock::now();
+        sample = duration<double, nano>(end - start).count();
+    }
+    return percentile(samples, 0.5);
+}
+
+// Половина запросов - значения из записей, половина - значение записи + 0.5
+// (ключи в данных целые, поэтому это промах внутри диапазона ключей)
+template<typename Getter>
+vector<float> make_queries(const vector<flight> &base, Getter getter, size_t count, uint32_t seed) {
+    mt19937 rng(seed);
+    vector<float> queries(count);
+    for (size_t i = 0; i < count; ++i) {
+        float value = getter(base[rng() % base.size()]);
+        queries[i] = i % 2 == 0 ? value : value + 0.5f;
+    }
+    shuffle(queries.begin(), queries.end(), rng);
+    return queries;
+}
+
+template<typename Getter>
+void benchmark_key(const string &key_name, const vector<flight> &base, Getter getter, size_t query_count,
+                   double overhead_ns) {
+    cout << "\n=== Ключ: " << key_name << " ===" << endl;
+
+    vector<float> values = make_queries(base, getter, query_count, 2024);
+
+    // Подготовка: каждая структура строится один раз, ее стоимость входит в стоимость алгоритмов
+    vector<flight> sorted_flights = base;
+    double sort_ms = time_ms([&] {
+        sort(sorted_flights.begin(), sorted_flights.end(), [&](const flight &a, const flight &b) {
+            return getter(a) < getter(b);
+        });
+    });
+    vector<float> column, sorted_column;
+    double column_ms = time_ms([&] { column = extract_column(base, getter); });
+    double sorted_column_ms = time_ms([&] { sorted_column = extract_column(sorted_flights, getter); });
+    EytzingerIndex<float> eytzinger;
+    double eytzinger_ms = time_ms([&] { eytzinger.build(sorted_column); });
+    KeyHashIndex<float> hash_index;
+    double hash_ms = time_ms([&] { hash_index.build(sorted_column); });
+
+    cout << "Подготовка, мс: сортировка записей " << fixed << setprecision(2) << sort_ms
+            << ", столбец " << column_ms << ", отсортированный столбец " << sorted_column_ms
+            << ", Eytzinger " << eytzinger_ms << ", хеш-индекс " << hash_ms
+            << " (различных ключей: " << hash_index.distinct_count() << ")" << endl;
+
+    auto sizes_of = [](const vector<IndexRange> &ranges) {
+        vector<size_t> sizes(ranges.size());
+        for (size_t i = 0; i < ranges.size(); ++i) sizes[i] = ranges[i].size();
+        return sizes;
+    };
+
+    vector<SearchAlgorithm> algorithms = {
+        {"linear_search_indices", 0.0,
+         [&](float q) { return linear_search_indices(base, getter, q).size(); }, nullptr, true},
+        {"linear_search (столбец)", column_ms,
+         [&](float q) { return linear_search(column, q).size(); }, nullptr, true},
+        {"parallel_linear_search_indices", 0.0,
+         [&](float q) { return parallel_linear_search_indices(base, getter, q).size(); }, nullptr, true},
+        {"equal_range_search", sort_ms,
+         [&](float q) { return equal_range_search(sorted_flights, getter, q).size(); }},
+        {"Fibonacci_search_range", sort_ms,
+         [&](float q) { return Fibonacci_search_range(sorted_flights, getter, q).size(); }},
+        {"interpolation_search_range", sort_ms,
+         [&](float q) { return interpolation_search_range(sorted_flights, getter, q).size(); }},
+        {"exponential_search_range", sort_ms,
+         [&](float q) { return exponential_search_range(sorted_flights, getter, q).size(); }},
+        {"branchless_lower_bound (столбец)", sort_ms + sorted_column_ms, [&](float q) {
+            auto first = sorted_column.begin() + branchless_lower_bound(sorted_column, q);
+            return static_cast<size_t>(upper_bound(first, sorted_column.end(), q) - first);
+        }},
+        {"EytzingerIndex::equal_range", sort_ms + sorted_column_ms + eytzinger_ms,
+         [&](float q) { return eytzinger.equal_range(q).size(); }},
+        {"KeyHashIndex::find", sort_ms + sorted_column_ms + hash_ms,
+         [&](float q) { return hash_index.find(q).size(); }},
+        {"batch_equal_range_search", sort_ms, nullptr,
+         [&](const vector<float> &qs) { return sizes_of(batch_equal_range_search(sorted_flights, getter, qs)); }},
+        {"KeyHashIndex::find_batch", sort_ms + sorted_column_ms + hash_ms, nullptr,
+         [&](const vector<float> &qs) { return sizes_of(hash_index.find_batch(qs)); }},
+    };
+
+    // Эталон: число записей с ключом, равным запросу; попадание - если оно не 0
+    vector<size_t> expected(values.size());
+    size_t hit_count = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        expected[i] = equal_range_search(sorted_flights, getter, values[i]).size();
+        hit_count += expected[i] > 0 ? 1 : 0;
+    }
+
+    cout << "Запросов: " << values.size() << " (попаданий: " << hit_count << ", линейным поиском: "
+            << min(values.size(), LINEAR_QUERY_LIMIT) << "), записей: " << base.size() << endl;
+    cout << cell("Алгоритм", 34) << cell("Подг., мс", 11) << cell("Сред. нс", 12) << cell("p50", 10)
+            << cell("p90", 10) << cell("p99", 11) << cell("p50 попад.", 12) << cell("p50 промах", 12)
+            << cell("Окупается", 12) << "Верно" << endl;
+    cout << string(130, '-') << endl;
+
+    double baseline_mean = 0.0;
+    for (const auto &algorithm: algorithms) {
+        size_t count = algorithm.limited ? min(values.size(), LINEAR_QUERY_LIMIT) : values.size();
+        bool correct = true;
+        double mean = 0.0;
+        vector<double> all, hits, misses;
+
+        if (algorithm.batch) {
+            vector<size_t> answers;
+            double ms = time_ms([&] { answers = algorithm.batch(values); });
+            mean = ms * 1e6 / max<size_t>(count, 1);
+            correct = answers == expected;
+        }
+        else {
+            for (size_t i = 0; i < min(count, WARMUP_QUERIES); ++i) {
+                algorithm.search(values[i]);
+            }
+            // Среднее - по сплошному прогону, перцентили - по замерам отдельных запросов
+            size_t checksum = 0;
+            double total_ms = time_ms([&] {
+                for (size_t i = 0; i < count; ++i) checksum += algorithm.search(values[i]);
+            });
+            mean = total_ms * 1e6 / max<size_t>(count, 1);
+
+            all.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                auto start = steady_clock::now();
+                size_t found = algorithm.search(values[i]);
+                auto end = steady_clock::now();
+                double ns = max(0.0, duration<double, nano>(end - start).count() - overhead_ns);
+                all.push_back(ns);
+                (expected[i] > 0 ? hits : misses).push_back(ns);
+                if (found != expected[i]) correct = false;
+            }
+            (void) checksum;
+        }
+
+        // Подготовка окупается, когда выигрыш на запросах относительно линейного поиска ее покрывает
+        string break_even = "-";
+        if (&algorithm == &algorithms.front()) {
+            baseline_mean = mean;
+        }
+        else if (algorithm.prepare_ms > 0) {
+            break_even = mean < baseline_mean
+                             ? to_string(static_cast<long long>(ceil(algorithm.prepare_ms * 1e6 / (baseline_mean - mean))))
+                             : "никогда";
+        }
+
+        bool has_percentiles = !all.empty();
+        cout << cell(algorithm.name, 34)
+                << cell(format_number(algorithm.prepare_ms, 2), 11)
+                << cell(format_number(mean, 1), 12)
+                << cell(has_percentiles ? format_number(percentile(all, 0.5), 0) : "-", 10)
+                << cell(has_percentiles ? format_number(percentile(all, 0.9), 0) : "-", 10)
+                << cell(has_percentiles ? format_number(percentile(all, 0.99), 0) : "-", 11)
+                << cell(has_percentiles ? format_number(percentile(hits, 0.5), 0) : "-", 12)
+                << cell(has_percentiles ? format_number(percentile(misses, 0.5), 0) : "-", 12)
+                << cell(break_even, 12)
+                << (correct ? "да" : "ОШИБКА") << endl;
+    }
+}
+
+// Виртуальный отсортированный столбец без памяти: элемент i равен i / DUPLICATES.
+// Нужен, чтобы проверить поиск на диапазонах больше 2^31 (и 2^32) элементов
+class CountingIterator {
+public:
+    using iterator_category = random_access_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = int64_t;
+    using pointer = const uint64_t *;
+    using reference = uint64_t;
+
+    static const uint64_t DUPLICATES = 3;
+
+    explicit CountingIterator(int64_t position = 0) : position(position) {}
+
+    uint64_t operator*() const { return static_cast<uint64_t>(position) / DUPLICATES; }
+    uint64_t operator[](int64_t offset) const { return *(*this + offset); }
+
+    CountingIterator &operator++() { ++position; return *this; }
+    CountingIterator &operator--() { --position; return *this; }
+    CountingIterator &operator+=(int64_t offset) { position += offset; return *this; }
+    CountingIterator &operator-=(int64_t offset) { position -= offset; return *this; }
+    CountingIterator operator+(int64_t offset) const { return CountingIterator(position + offset); }
+    CountingIterator operator-(int64_t offset) const { return CountingIterator(position - offset); }
+    int64_t operator-(const CountingIterator &other) const { return position - other.position; }
+
+    bool operator==(const CountingIterator &other) const { return position == other.position; }
+    bool operator!=(const CountingIterator &other) const { return position != other.position; }
+    bool operator<(const CountingIterator &other) const { return position < other.position; }
+
+private:
+    int64_t position;
+};
+
+// Поиск по виртуальному столбцу из 5 * 10^9 элементов с проекцией 2 * v: четные запросы -
+// попадания (по DUPLICATES элементов), нечетные - промахи. Ответ известен заранее
+void check_large_ranges(size_t query_count) {
+    const int64_t n = 5000000011LL;
+    const uint64_t max_key = static_cast<uint64_t>(n - 1) / CountingIterator::DUPLICATES;
+    CountingIterator first(0), last(n);
+    auto proj = [](uint64_t v) { return 2 * v; };
+
+    cout << "\n=== Проверка на " << n << " элементах (больше 2^32, виртуальный столбец) ===" << endl;
+
+    mt19937_64 rng(77);
+    vector<uint64_t> queries(query_count);
+    for (auto &q: queries) {
+        q = rng() % (2 * max_key + 8);
+    }
+    // Ожидаемые границы: ключ k = q / 2 занимает позиции [3k, 3k + 3)
+    auto expected_lower = [&](uint64_t q) {
+        uint64_t k = q / 2 + (q % 2);
+        return static_cast<int64_t>(min<uint64_t>(static_cast<uint64_t>(n), k * CountingIterator::DUPLICATES));
+    };
+    auto expected_upper = [&](uint64_t q) {
+        return q % 2 == 1 ? expected_lower(q) : expected_lower(q + 2);
+    };
+
+    auto check = [&](const string &name, auto search) {
+        bool correct = true;
+        auto start = steady_clock::now();
+        for (uint64_t q: queries) {
+            pair<int64_t, int64_t> range = search(q);
+            int64_t lower = expected_lower(q), upper = expected_upper(q);
+            // Fibonacci поиск возвращает для промаха {last, last}: проверяется только пустота
+            bool ok = range.first == lower && range.second == upper;
+            if (!ok && lower == upper) ok = range.first == range.second;
+            if (!ok) correct = false;
+        }
+        auto end = steady_clock::now();
+        double ns = duration<double, nano>(end - start).count() / max<size_t>(queries.size(), 1);
+        cout << cell(name, 44) << setw(10) << right << fixed << setprecision(1) << ns << left
+                << " нс/запрос  " << (correct ? "да" : "ОШИБКА") << endl;
+    };
+
+    auto positions = [&](CountingIterator a, CountingIterator b) { return make_pair(a - first, b - first); };
+    check("lower_bound_by + upper_bound_by", [&](uint64_t q) {
+        return positions(lower_bound_by(first, last, q, proj), upper_bound_by(first, last, q, proj));
+    });
+    check("equal_range_by", [&](uint64_t q) {
+        auto range = equal_range_by(first, last, q, proj);
+        return positions(range.first, range.second);
+    });
+    check("fibonacci_equal_range_by", [&](uint64_t q) {
+        auto range = fibonacci_equal_range_by(first, last, q, proj);
+        return positions(range.first, range.second);
+    });
+    check("interpolation_lower_bound_by + галоп", [&](uint64_t q) {
+        auto lower = interpolation_lower_bound_by(first, last, q, proj);
+        return positions(lower, gallop_upper_bound_by(lower, last, q, proj));
+    });
+    check("gallop_lower_bound_by (экспоненциальный)", [&](uint64_t q) {
+        auto lower = gallop_lower_bound_by(first, last, q, proj);
+        return positions(lower, gallop_upper_bound_by(lower, last, q, proj));
+    });
+}
+
+int main(int argc, char *argv[]) {
+    string csv_file = argc > 1 ? argv[1] : "../data/flight_data_2024_semicolon.csv";
+    size_t max_records = argc > 2 ? strtoull(argv[2], nullptr, 10) : 0;
+    size_t query_count = argc > 3 ? max<size_t>(1, strtoull(argv[3], nullptr, 10)) : 10000;
+
+    cout << "=== БЕНЧМАРК ПОИСКА ===" << endl;
+
+    check_large_ranges(query_count);
+
+    cout << "\nФайл: " << csv_file << endl;
+
+    auto flights = read_flights_by_strings(csv_file, true, max_records);
+    if (flights.empty()) {
+        cerr << "Ошибка: не удалось загрузить данные" << endl;
+        return 1;
+    }
+    // Порядок обхода unordered_set не связан с ключами - это несортированный вход
+    vector<flight> base(flights.begin(), flights.end());
+    flights.clear();
+
+    double overhead_ns = timer_overhead_ns();
+    cout << "Записей: " << base.size() << ", запросов на ключ: " << query_count << endl;
+    cout << "Потоков в пуле: " << ThreadPool::shared().size()
+            << ", стоимость замера (вычитается): " << fixed << setprecision(1) << overhead_ns << " нс" << endl;
+    cout << "Окупается - после скольких запросов подготовка дешевле, чем linear_search_indices по записям" << endl;
+
+    benchmark_key("дистанция", base, [](const flight &f) { return f.getDistance(); }, query_count, overhead_ns);
+    benchmark_key("задержка прибытия", base, [](const flight &f) { return f.get_arr_delay(); }, query_count,
+                  overhead_ns);
+    benchmark_key("номер рейса", base, [](const flight &f) { return f.get_flight_number(); }, query_count,
+                  overhead_ns);
+
+    return 0;
+}
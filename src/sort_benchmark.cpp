@@ -0,0 +1,267 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <cstdlib>
+
+#include "flight.h"
+#include "reading_by_instances.h"
+#include "benchmark_table.h"
+#include "sort_keys.h"
+#include "sorting.h"
+
+// Бенчмарк сортировок: несколько размеров (10K..весь файл) и распределений,
+// полученных из реальных данных, прогрев, медиана и p95 по повторам,
+// пропускная способность, число сравнений и перемещений записей.
+//
+// Запуск: SortBenchmark [csv-файл] [макс. записей, 0 = все] [повторов]
+
+using namespace std;
+using namespace std::chrono;
+
+// Порядок-обертка, считающий сравнения и перемещения (через on_moves, см. sorting.h).
+// Счетчики атомарные, поэтому замеры времени делаются отдельно, с исходным порядком
+template<typename Order>
+struct CountingOrder {
+    static inline atomic<long long> comparisons{0};
+    static inline atomic<long long> moves{0};
+
+    static void reset() {
+        comparisons = 0;
+        moves = 0;
+    }
+
+    static int compare(const flight &a, const flight &b) {
+        comparisons.fetch_add(1, memory_order_relaxed);
+        return Order::compare(a, b);
+    }
+
+    static void on_moves(size_t n) {
+        moves.fetch_add(static_cast<long long>(n), memory_order_relaxed);
+    }
+
+    bool operator()(const flight &a, const flight &b) const {
+        return compare(a, b) < 0;
+    }
+};
+
+// Сколько перемещений записей делает apply_permutation: каждый нетривиальный цикл
+// длины L стоит L + 1 перемещений (через временную переменную)
+long long permutation_moves(const vector<uint32_t> &perm) {
+    vector<bool> seen(perm.size(), false);
+    long long moves = 0;
+    for (size_t start = 0; start < perm.size(); ++start) {
+        if (seen[start] || perm[start] == start) continue;
+        size_t length = 0;
+        for (size_t j = start; !seen[j]; j = perm[j]) {
+            seen[j] = true;
+            length++;
+        }
+        moves += static_cast<long long>(length) + 1;
+    }
+    return moves;
+}
+
+struct SortAlgorithm {
+    string name;
+    function<void(vector<flight> &)> run;
+    // Отдельный прогон для подсчета: {сравнения, перемещения}, -1 - не измеряется
+    function<pair<long long, long long>(vector<flight> &)> count;
+};
+
+template<typename Order>
+vector<SortAlgorithm> algorithms_for() {
+    using Counting = CountingOrder<Order>;
+    auto counted = [](auto sort) {
+        return [sort](vector<flight> &data) {
+            Counting::reset();
+            sort(data);
+            return make_pair(Counting::comparisons.load(), Counting::moves.load());
+        };
+    };
+
+    return {
+        {
+            "mergeSortBy",
+            [](vector<flight> &data) { mergeSortBy<Order>(data); },
+            counted([](vector<flight> &data) { mergeSortBy<Counting>(data); })
+        },
+        {
+            "parallelMergeSortBy",
+            [](vector<flight> &data) { parallelMergeSortBy<Order>(data); },
+            counted([](vector<flight> &data) { parallelMergeSortBy<Counting>(data); })
+        },
+        {
+            "sortBy (std::sort)",
+            [](vector<flight> &data) { sortBy<Order>(data); },
+            [](vector<flight> &data) {
+                Counting::reset();
+                sortBy<Counting>(data);
+                return make_pair(Counting::comparisons.load(), -1LL);
+            }
+        },
+        {
+            "std::stable_sort",
+            [](vector<flight> &data) { stable_sort(data.begin(), data.end(), Order()); },
+            [](vector<flight> &data) {
+                Counting::reset();
+                stable_sort(data.begin(), data.end(), Counting());
+                return make_pair(Counting::comparisons.load(), -1LL);
+            }
+        },
+        {
+            // Сравниваются упакованные ключи, а не записи
+            "sortPermutationBy + apply",
+            [](vector<flight> &data) { apply_permutation(data, sortPermutationBy<Order>(data)); },
+            [](vector<flight> &data) {
+                auto perm = sortPermutationBy<Order>(data);
+                long long moves = permutation_moves(perm);
+                apply_permutation(data, perm);
+                return make_pair(-1LL, moves);
+            }
+        },
+        {
+            "radixSortPermutationBy + apply",
+            [](vector<flight> &data) { apply_permutation(data, radixSortPermutationBy<Order>(data)); },
+            [](vector<flight> &data) {
+                auto perm = radixSortPermutationBy<Order>(data);
+                long long moves = permutation_moves(perm);
+                apply_permutation(data, perm);
+                return make_pair(0LL, moves);
+            }
+        }
+    };
+}
+
+// Распределение входа размера n, построенное из реальных записей
+struct Distribution {
+    string name;
+    function<vector<flight>(const vector<flight> &, size_t)> make;
+};
+
+template<typename Order>
+vector<Distribution> distributions_for() {
+    return {
+        {"случайный", [](const vector<flight> &base, size_t n) {
+            return vector<flight>(base.begin(), base.begin() + n);
+        }},
+        {"отсортированный", [](const vector<flight> &base, size_t n) {
+            vector<flight> data(base.begin(), base.begin() + n);
+            apply_permutation(data, radixSortPermutationBy<Order>(data));
+            return data;
+        }},
+        {"обратный", [](const vector<flight> &base, size_t n) {
+            vector<flight> data(base.begin(), base.begin() + n);
+            apply_permutation(data, radixSortPermutationBy<Order>(data));
+            reverse(data.begin(), data.end());
+            return data;
+        }},
+        // 64 различные записи, повторенные в случайном порядке
+        {"много дубликатов", [](const vector<flight> &base, size_t n) {
+            const size_t DISTINCT = 64;
+            mt19937 rng(42);
+            size_t pool_size = min(DISTINCT, n);
+            vector<flight> data;
+            data.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                data.push_back(base[rng() % pool_size]);
+            }
+            return data;
+        }}
+    };
+}
+
+template<typename Order>
+void benchmark_order(const string &order_name, const vector<flight> &base,
+                     const vector<size_t> &sizes, size_t repeats) {
+    cout << "\n=== Порядок: " << order_name << " ===" << endl;
+
+    auto algorithms = algorithms_for<Order>();
+    auto distributions = distributions_for<Order>();
+
+    for (size_t n: sizes) {
+        for (const auto &distribution: distributions) {
+            vector<flight> input = distribution.make(base, n);
+
+            cout << "\nРазмер: " << n << ", распределение: " << distribution.name << endl;
+            cout << cell("Алгоритм", 34) << cell("Медиана, мс", 14) << cell("p95, мс", 14)
+                    << cell("Млн зап/с", 14) << cell("Сравнений", 16) << cell("Перемещений", 16)
+                    << "Порядок" << endl;
+            cout << string(114, '-') << endl;
+
+            for (const auto &algorithm: algorithms) {
+                // Прогрев: кэши, аллокатор, потоки пула
+                {
+                    vector<flight> data = input;
+                    algorithm.run(data);
+                }
+
+                vector<double> times;
+                bool correct = true;
+                for (size_t r = 0; r < repeats; ++r) {
+                    vector<flight> data = input;
+                    auto start = steady_clock::now();
+                    algorithm.run(data);
+                    auto end = steady_clock::now();
+                    times.push_back(duration<double, milli>(end - start).count());
+                    if (r == 0) {
+                        correct = is_sorted(data.begin(), data.end(), Order());
+                    }
+                }
+
+                vector<flight> data = input;
+                auto counts = algorithm.count(data);
+
+                double median = percentile(times, 0.5);
+                double p95 = percentile(times, 0.95);
+                double throughput = median > 0 ? n / (median / 1000.0) / 1e6 : 0.0;
+
+                cout << cell(algorithm.name, 34) << left
+                        << setw(14) << fixed << setprecision(3) << median
+                        << setw(14) << fixed << setprecision(3) << p95
+                        << setw(14) << fixed << setprecision(2) << throughput
+                        << setw(16) << (counts.first < 0 ? string("-") : to_string(counts.first))
+                        << setw(16) << (counts.second < 0 ? string("-") : to_string(counts.second))
+                        << (correct ? "да" : "ОШИБКА") << endl;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    string csv_file = argc > 1 ? argv[1] : "../data/flight_data_2024_semicolon.csv";
+    size_t max_records = argc > 2 ? strtoull(argv[2], nullptr, 10) : 0;
+    size_t repeats = argc > 3 ? max<size_t>(1, strtoull(argv[3], nullptr, 10)) : 5;
+
+    cout << "=== БЕНЧМАРК СОРТИРОВОК ===" << endl;
+    cout << "Файл: " << csv_file << endl;
+
+    auto flights = read_flights_by_strings(csv_file, true, max_records);
+    if (flights.empty()) {
+        cerr << "Ошибка: не удалось загрузить данные" << endl;
+        return 1;
+    }
+    // Порядок обхода unordered_set не связан с ключами сортировки - это "случайный" вход
+    vector<flight> base(flights.begin(), flights.end());
+    flights.clear();
+
+    vector<size_t> sizes;
+    for (size_t n: {size_t{10000}, size_t{100000}, size_t{1000000}}) {
+        if (n < base.size()) sizes.push_back(n);
+    }
+    sizes.push_back(base.size());
+
+    cout << "Записей: " << base.size() << ", повторов: " << repeats << " (+1 прогрев)" << endl;
+    cout << "Потоков в пуле: " << ThreadPool::shared().size() << endl;
+
+    benchmark_order<ArrivalDelayOrder>("ArrivalDelayOrder (задержка прибытия)", base, sizes, repeats);
+    benchmark_order<SpecialFlightOrder>("SpecialFlightOrder (отмена, штат, задержка)", base, sizes, repeats);
+
+    return 0;
+}
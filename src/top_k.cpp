@@ -0,0 +1,55 @@
+#include "top_k.h"
+#include "column_scan.h"
+#include <limits>
+
+using namespace std;
+
+vector<size_t> top_k_indices(const vector<float>& values, size_t k) {
+    const size_t n = values.size();
+    if (k == 0 || n == 0) {
+        return {};
+    }
+
+    // Выборка с шагом по всему столбцу; K-е наибольшее в ней - нижняя оценка
+    // K-го наибольшего во всем столбце, поэтому все K лучших окажутся >= порога
+    float threshold = -numeric_limits<float>::infinity();
+    if (k < n) {
+        const size_t SAMPLE_MIN = 4096;
+        size_t sample_size = min(n, max(SAMPLE_MIN, 8 * k));
+        size_t step = n / sample_size;
+        vector<float> sample;
+        sample.reserve(sample_size);
+        for (size_t i = 0; i < n && sample.size() < sample_size; i += step) {
+            if (values[i] == values[i]) {
+                sample.push_back(values[i]);
+            }
+        }
+        if (sample.size() >= k) {
+            nth_element(sample.begin(), sample.begin() + (k - 1), sample.end(), greater<float>());
+            threshold = sample[k - 1];
+        }
+    }
+
+    vector<size_t> candidates;
+    select_greater_equal(values.data(), n, threshold, candidates);
+
+    auto better = [&values](size_t a, size_t b) {
+        return values[a] > values[b] || (values[a] == values[b] && a < b);
+    };
+    if (candidates.size() > k) {
+        nth_element(candidates.begin(), candidates.begin() + k, candidates.end(), better);
+        candidates.resize(k);
+    }
+    sort(candidates.begin(), candidates.end(), better);
+    return candidates;
+}
+
+vector<const flight*> top_k_by_arr_delay(const vector<flight>& flights, size_t k) {
+    vector<size_t> indices = top_k_indices(extract_arr_delay(flights), k);
+    vector<const flight*> result;
+    result.reserve(indices.size());
+    for (size_t index : indices) {
+        result.push_back(&flights[index]);
+    }
+    return result;
+}